@@ -0,0 +1,87 @@
+#include "fault-index.hpp"
+
+#include <algorithm>
+
+namespace phosphor
+{
+namespace led
+{
+namespace fru
+{
+namespace fault
+{
+namespace monitor
+{
+
+FaultChanges FaultIndex::update(const std::string& entry,
+                                std::vector<std::string> paths)
+{
+    FaultChanges changes;
+
+    // The callouts the entry no longer has are resolved
+    auto iter = callouts.find(entry);
+    if (iter != callouts.end())
+    {
+        for (const auto& path : iter->second)
+        {
+            if (std::ranges::find(paths, path) == paths.end() &&
+                closeFault(path, entry))
+            {
+                changes.deasserted.emplace_back(path);
+            }
+        }
+    }
+
+    for (const auto& path : paths)
+    {
+        if (openFault(path, entry))
+        {
+            changes.asserted.emplace_back(path);
+        }
+    }
+
+    if (paths.empty())
+    {
+        if (iter != callouts.end())
+        {
+            callouts.erase(iter);
+        }
+    }
+    else
+    {
+        callouts.insert_or_assign(entry, std::move(paths));
+    }
+
+    return changes;
+}
+
+bool FaultIndex::openFault(const std::string& path, const std::string& entry)
+{
+    auto& entries = faults[path];
+    auto [iter, inserted] = entries.emplace(entry);
+    return inserted && entries.size() == 1;
+}
+
+bool FaultIndex::closeFault(const std::string& path, const std::string& entry)
+{
+    auto iter = faults.find(path);
+    if (iter == faults.end() || iter->second.erase(entry) == 0)
+    {
+        // Already resolved
+        return false;
+    }
+
+    if (!iter->second.empty())
+    {
+        return false;
+    }
+
+    faults.erase(iter);
+    return true;
+}
+
+} // namespace monitor
+} // namespace fault
+} // namespace fru
+} // namespace led
+} // namespace phosphor
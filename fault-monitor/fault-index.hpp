@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace phosphor
+{
+namespace led
+{
+namespace fru
+{
+namespace fault
+{
+namespace monitor
+{
+
+/** @brief FRUs whose fault LED changes after a log entry update */
+struct FaultChanges
+{
+    /** @brief FRUs with their first open fault */
+    std::vector<std::string> asserted;
+
+    /** @brief FRUs with no open fault left */
+    std::vector<std::string> deasserted;
+};
+
+/** @class FaultIndex
+ *  @brief Open log entries and the FRUs they call out
+ *  @details The callouts are indexed by entry path, and the open entries
+ *           are counted per FRU, so the LED of a FRU is asserted by its
+ *           first open fault and deasserted when the last one is resolved.
+ */
+class FaultIndex
+{
+  public:
+    /** @brief Sets the FRUs called out by a log entry
+     *  @details An entry is resolved by phosphor-logging by clearing its
+     *           associations, so an empty list closes all its faults.
+     *  @param[in] entry - Path of the log entry
+     *  @param[in] paths - Inventory paths of the FRUs called out
+     *  @return the FRUs whose fault LED changes
+     */
+    FaultChanges update(const std::string& entry,
+                        std::vector<std::string> paths);
+
+    /** @brief Drops a deleted log entry
+     *  @param[in] entry - Path of the log entry
+     *  @return the FRUs whose fault LED changes
+     */
+    inline FaultChanges remove(const std::string& entry)
+    {
+        return update(entry, {});
+    }
+
+    /** @brief Whether a FRU has an open fault
+     *  @param[in] path - Inventory path of the FRU
+     */
+    inline bool isFaulted(const std::string& path) const
+    {
+        return faults.contains(path);
+    }
+
+  private:
+    /** @brief Inventory paths called out, by open log entry path */
+    std::unordered_map<std::string, std::vector<std::string>> callouts;
+
+    /** @brief Open log entry paths, by inventory path */
+    std::unordered_map<std::string, std::unordered_set<std::string>> faults;
+
+    /** @brief Records an open log entry calling out a FRU
+     *  @param[in] path  - Inventory path of the FRU
+     *  @param[in] entry - Path of the log entry
+     *  @return true if this is the first open entry for the FRU
+     */
+    bool openFault(const std::string& path, const std::string& entry);
+
+    /** @brief Records a resolved log entry calling out a FRU
+     *  @param[in] path  - Inventory path of the FRU
+     *  @param[in] entry - Path of the log entry
+     *  @return true if no open entry is left for the FRU
+     */
+    bool closeFault(const std::string& path, const std::string& entry);
+};
+
+} // namespace monitor
+} // namespace fault
+} // namespace fru
+} // namespace led
+} // namespace phosphor
@@ -6,6 +6,11 @@
 #include <sdbusplus/exception.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <optional>
+
 namespace phosphor
 {
 namespace led
@@ -26,6 +31,7 @@ constexpr auto OBJMGR_IFACE = "org.freedesktop.DBus.ObjectManager";
 constexpr auto LED_GROUPS = "/xyz/openbmc_project/led/groups/";
 constexpr auto LOG_PATH = "/xyz/openbmc_project/logging";
 constexpr auto LOG_IFACE = "xyz.openbmc_project.Logging.Entry";
+constexpr auto ASSOC_IFACE = "xyz.openbmc_project.Association.Definitions";
 
 using AssociationList =
     std::vector<std::tuple<std::string, std::string, std::string>>;
@@ -35,12 +41,8 @@ using PropertyMap = std::unordered_map<PropertyName, Attributes>;
 using InterfaceName = std::string;
 using InterfaceMap = std::unordered_map<InterfaceName, PropertyMap>;
 
-using Service = std::string;
-using Path = std::string;
-using Interface = std::string;
-using Interfaces = std::vector<Interface>;
-using MapperResponseType =
-    std::unordered_map<Path, std::unordered_map<Service, Interfaces>>;
+using ManagedObjects =
+    std::map<sdbusplus::message::object_path, InterfaceMap>;
 
 using ResourceNotFoundErr =
     sdbusplus::xyz::openbmc_project::Common::Error::ResourceNotFound;
@@ -77,21 +79,12 @@ std::string getService(sdbusplus::bus::bus& bus, const std::string& path)
     return mapperResponse.cbegin()->first;
 }
 
-void action(sdbusplus::bus::bus& bus, const std::string& path, bool assert)
+/** @brief Returns the fault LED group of a FRU
+ *  @param[in] path - Inventory path of the FRU
+ *  @return the LED group path, empty if the inventory path is not valid
+ */
+std::string getFaultGroup(const std::string& path)
 {
-    std::string service;
-    try
-    {
-        std::string groups{LED_GROUPS};
-        groups.pop_back();
-        service = getService(bus, groups);
-    }
-    catch (const ResourceNotFoundErr& e)
-    {
-        commit<ResourceNotFoundErr>();
-        return;
-    }
-
     auto pos = path.rfind("/");
     if (pos == std::string::npos)
     {
@@ -99,41 +92,177 @@ void action(sdbusplus::bus::bus& bus, const std::string& path, bool assert)
         report<InvalidArgumentErr>(
             InvalidArgument::ARGUMENT_NAME("path"),
             InvalidArgument::ARGUMENT_VALUE(path.c_str()));
-        return;
+        return {};
     }
     auto unit = path.substr(pos + 1);
 
-    std::string ledPath = LED_GROUPS + unit + '_' + LED_FAULT;
+    return LED_GROUPS + unit + '_' + LED_FAULT;
+}
 
-    auto method = bus.new_method_call(service.c_str(), ledPath.c_str(),
-                                      "org.freedesktop.DBus.Properties", "Set");
-    method.append("xyz.openbmc_project.Led.Group");
-    method.append("Asserted");
+/** @brief Returns the FRUs called out by association definitions
+ *  @param[in] properties - Properties of the association definitions
+ *  @return the inventory paths of the FRUs
+ */
+std::vector<std::string> getCallouts(const PropertyMap& properties)
+{
+    std::vector<std::string> paths;
 
-    method.append(std::variant<bool>(assert));
+    auto attr = properties.find("Associations");
+    if (attr == properties.end())
+    {
+        return paths;
+    }
 
-    try
+    auto assocs = std::get_if<AssociationList>(&attr->second);
+    if (assocs == nullptr)
     {
-        bus.call_noreply(method);
+        return paths;
     }
-    catch (const sdbusplus::exception::exception& e)
+
+    for (const auto& item : *assocs)
     {
-        // Log an info message, system may not have all the LED Groups defined
-        lg2::info("Failed to Assert LED Group, ERROR = {ERROR}", "ERROR", e);
+        if (std::get<1>(item).compare(CALLOUT_REV_ASSOCIATION) == 0)
+        {
+            paths.emplace_back(std::get<2>(item));
+        }
     }
 
-    return;
+    return paths;
 }
 
-void Add::created(sdbusplus::message::message& msg)
+/** @brief Returns the FRUs called out by a log entry
+ *  @param[in] interfaces - Interfaces and properties of the log entry
+ *  @return the inventory paths of the FRUs
+ */
+std::vector<std::string> getCallouts(const InterfaceMap& interfaces)
 {
-    auto bus = msg.get_bus();
+    auto iter = interfaces.find(ASSOC_IFACE);
+    if (iter == interfaces.end())
+    {
+        return {};
+    }
 
+    return getCallouts(iter->second);
+}
+
+/** @brief Returns the return code of an sd-bus message call
+ *  @param[in] r    - The return code
+ *  @param[in] call - Name of the call, used on failure
+ *  @throws sdbusplus::exception::SdBusError if the call failed
+ */
+int check(int r, const char* call)
+{
+    if (r < 0)
+    {
+        throw sdbusplus::exception::SdBusError(-r, call);
+    }
+    return r;
+}
+
+/** @brief Reads the FRUs called out by an InterfacesAdded message
+ *  @details The interfaces and properties are walked in place, only the
+ *           Associations property is decoded and the rest is skipped.
+ *  @param[in] msg - InterfacesAdded message, positioned after the path
+ *  @return the inventory paths called out, std::nullopt if the object has
+ *          no association definitions
+ */
+std::optional<std::vector<std::string>>
+    readCallouts(sdbusplus::message::message& msg)
+{
+    auto m = msg.get();
+    std::optional<std::vector<std::string>> paths;
+
+    check(sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY, "{sa{sv}}"),
+          "sd_bus_message_enter_container");
+    while (check(sd_bus_message_enter_container(m, SD_BUS_TYPE_DICT_ENTRY,
+                                                "sa{sv}"),
+                 "sd_bus_message_enter_container") > 0)
+    {
+        const char* interface = nullptr;
+        check(sd_bus_message_read_basic(m, SD_BUS_TYPE_STRING, &interface),
+              "sd_bus_message_read_basic");
+        if (strcmp(interface, ASSOC_IFACE) != 0)
+        {
+            check(sd_bus_message_skip(m, "a{sv}"), "sd_bus_message_skip");
+            check(sd_bus_message_exit_container(m),
+                  "sd_bus_message_exit_container");
+            continue;
+        }
+
+        paths.emplace();
+        check(sd_bus_message_enter_container(m, SD_BUS_TYPE_ARRAY, "{sv}"),
+              "sd_bus_message_enter_container");
+        while (check(sd_bus_message_enter_container(m, SD_BUS_TYPE_DICT_ENTRY,
+                                                    "sv"),
+                     "sd_bus_message_enter_container") > 0)
+        {
+            const char* property = nullptr;
+            check(sd_bus_message_read_basic(m, SD_BUS_TYPE_STRING, &property),
+                  "sd_bus_message_read_basic");
+            if (strcmp(property, "Associations") != 0)
+            {
+                check(sd_bus_message_skip(m, "v"), "sd_bus_message_skip");
+            }
+            else
+            {
+                check(sd_bus_message_enter_container(m, SD_BUS_TYPE_VARIANT,
+                                                     "a(sss)"),
+                      "sd_bus_message_enter_container");
+                AssociationList assocs;
+                msg.read(assocs);
+                check(sd_bus_message_exit_container(m),
+                      "sd_bus_message_exit_container");
+
+                for (const auto& item : assocs)
+                {
+                    if (std::get<1>(item).compare(CALLOUT_REV_ASSOCIATION) ==
+                        0)
+                    {
+                        paths->emplace_back(std::get<2>(item));
+                    }
+                }
+            }
+            check(sd_bus_message_exit_container(m),
+                  "sd_bus_message_exit_container");
+        }
+        check(sd_bus_message_exit_container(m),
+              "sd_bus_message_exit_container");
+        check(sd_bus_message_exit_container(m),
+              "sd_bus_message_exit_container");
+    }
+    check(sd_bus_message_exit_container(m), "sd_bus_message_exit_container");
+
+    return paths;
+}
+
+void action(GroupClient& client, const std::string& path, bool assert)
+{
+    auto ledPath = getFaultGroup(path);
+    if (ledPath.empty())
+    {
+        return;
+    }
+
+    client.set(ledPath, assert);
+}
+
+void Add::created(sdbusplus::message::message& msg)
+{
     sdbusplus::message::object_path objectPath;
-    InterfaceMap interfaces;
+    std::optional<std::vector<std::string>> callout;
     try
     {
-        msg.read(objectPath, interfaces);
+        msg.read(objectPath);
+
+        // Check the path before walking the interfaces of the object
+        std::size_t found = objectPath.str.find(ELOG_ENTRY);
+        if (found == std::string::npos)
+        {
+            // Not a new error entry skip
+            return;
+        }
+
+        callout = readCallouts(msg);
     }
     catch (const sdbusplus::exception::exception& e)
     {
@@ -142,14 +271,7 @@ void Add::created(sdbusplus::message::message& msg)
         return;
     }
 
-    std::size_t found = objectPath.str.find(ELOG_ENTRY);
-    if (found == std::string::npos)
-    {
-        // Not a new error entry skip
-        return;
-    }
-    auto iter = interfaces.find("xyz.openbmc_project.Association.Definitions");
-    if (iter == interfaces.end())
+    if (!callout)
     {
         return;
     }
@@ -160,117 +282,143 @@ void Add::created(sdbusplus::message::message& msg)
     // directly.
     lg2::info("{PATH} created", "PATH", objectPath.str);
 
-    auto attr = iter->second.find("Associations");
-    if (attr == iter->second.end())
+    if (callout->empty())
     {
+        // No callouts skip
         return;
     }
 
-    auto& assocs = std::get<AssociationList>(attr->second);
-    if (assocs.empty())
+    apply(index.update(objectPath.str, std::move(*callout)));
+}
+
+void Add::removed(sdbusplus::message::message& msg)
+{
+    sdbusplus::message::object_path objectPath;
+    std::vector<std::string> interfaces;
+    try
     {
-        // No associations skip
+        msg.read(objectPath, interfaces);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse removed message, ERROR = {ERROR}", "ERROR",
+                   e);
         return;
     }
 
-    for (const auto& item : assocs)
+    if (std::find(interfaces.begin(), interfaces.end(), LOG_IFACE) ==
+        interfaces.end())
     {
-        if (std::get<1>(item).compare(CALLOUT_REV_ASSOCIATION) == 0)
-        {
-            removeWatches.emplace_back(
-                std::make_unique<Remove>(bus, std::get<2>(item)));
-            action(bus, std::get<2>(item), true);
-        }
+        // The log entry is still there
+        return;
     }
 
-    return;
+    apply(index.remove(objectPath.str));
 }
 
-void getLoggingSubTree(sdbusplus::bus::bus& bus, MapperResponseType& subtree)
+void Add::changed(sdbusplus::message::message& msg)
 {
-    auto depth = 0;
-    auto mapperCall = bus.new_method_call(MAPPER_BUSNAME, MAPPER_OBJ_PATH,
-                                          MAPPER_IFACE, "GetSubTree");
-    mapperCall.append("/");
-    mapperCall.append(depth);
-    mapperCall.append(std::vector<Interface>({LOG_IFACE}));
+    std::string objectPath = msg.get_path();
+    if (objectPath.find(ELOG_ENTRY) == std::string::npos)
+    {
+        return;
+    }
 
+    std::string interface;
+    PropertyMap properties;
     try
     {
-        auto mapperResponseMsg = bus.call(mapperCall);
-        mapperResponseMsg.read(subtree);
+        msg.read(interface, properties);
     }
     catch (const sdbusplus::exception::exception& e)
     {
-        lg2::error(
-            "Failed to parse existing callouts subtree message, ERROR = {ERROR}",
-            "ERROR", e);
+        lg2::error("Failed to parse changed message, ERROR = {ERROR}", "ERROR",
+                   e);
+        return;
     }
+
+    if (!properties.contains("Associations"))
+    {
+        return;
+    }
+
+    // Resolving the entry clears its callouts
+    apply(index.update(objectPath, getCallouts(properties)));
 }
 
-void Add::processExistingCallouts(sdbusplus::bus::bus& bus)
+void Add::apply(const FaultChanges& changes)
 {
-    MapperResponseType mapperResponse;
+    // The LED stays asserted while another fault of the FRU is open
+    for (const auto& path : changes.asserted)
+    {
+        action(client, path, true);
+    }
+    for (const auto& path : changes.deasserted)
+    {
+        action(client, path, false);
+    }
+}
 
-    getLoggingSubTree(bus, mapperResponse);
-    if (mapperResponse.empty())
+void action(GroupClient& client, const std::set<std::string>& paths,
+            bool assert)
+{
+    std::map<std::string, bool> groups;
+    for (const auto& path : paths)
     {
-        // No errors to process.
+        auto ledPath = getFaultGroup(path);
+        if (!ledPath.empty())
+        {
+            groups.emplace(ledPath, assert);
+        }
+    }
+
+    client.set(groups);
+}
+
+void Add::processExistingCallouts(sdbusplus::bus::bus& bus)
+{
+    std::string service;
+    try
+    {
+        service = getService(bus, LOG_PATH);
+    }
+    catch (const ResourceNotFoundErr& e)
+    {
+        // No logging service, no errors to process.
         return;
     }
 
-    for (const auto& elem : mapperResponse)
+    // All the entries and their associations are fetched at once, instead of
+    // one call per entry.
+    ManagedObjects objects;
+    try
     {
-        auto method = bus.new_method_call(
-            elem.second.begin()->first.c_str(), elem.first.c_str(),
-            "org.freedesktop.DBus.Properties", "Get");
-        method.append("xyz.openbmc_project.Association.Definitions");
-        method.append("Associations");
+        auto method = bus.new_method_call(service.c_str(), LOG_PATH,
+                                          OBJMGR_IFACE, "GetManagedObjects");
         auto reply = bus.call(method);
-        if (reply.is_method_error())
-        {
-            // do not stop, continue with next elog
-            lg2::error("Error in getting associations");
-            continue;
-        }
+        reply.read(objects);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to get the existing callouts, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
 
-        std::variant<AssociationList> assoc;
-        try
-        {
-            reply.read(assoc);
-        }
-        catch (const sdbusplus::exception::exception& e)
-        {
-            lg2::error(
-                "Failed to parse existing callouts associations message, ERROR = {ERROR}",
-                "ERROR", e);
-            continue;
-        }
-        auto& assocs = std::get<AssociationList>(assoc);
-        if (assocs.empty())
+    std::set<std::string> faulted;
+    for (const auto& [objectPath, interfaces] : objects)
+    {
+        if (objectPath.str.find(ELOG_ENTRY) == std::string::npos)
         {
-            // no associations, skip
             continue;
         }
 
-        for (const auto& item : assocs)
-        {
-            if (std::get<1>(item).compare(CALLOUT_REV_ASSOCIATION) == 0)
-            {
-                removeWatches.emplace_back(
-                    std::make_unique<Remove>(bus, std::get<2>(item)));
-                action(bus, std::get<2>(item), true);
-            }
-        }
+        auto changes = index.update(objectPath.str, getCallouts(interfaces));
+        faulted.insert(changes.asserted.begin(), changes.asserted.end());
     }
-}
-
-void Remove::removed(sdbusplus::message::message& msg)
-{
-    auto bus = msg.get_bus();
 
-    action(bus, inventoryPath, false);
-    return;
+    // One update for all the faulted FRUs
+    action(client, faulted, true);
 }
 
 } // namespace monitor
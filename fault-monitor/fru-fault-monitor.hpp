@@ -2,10 +2,18 @@
 
 #include "config.h"
 
+#include "fault-index.hpp"
+#include "group-client.hpp"
+
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server.hpp>
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
 
+#include <set>
 #include <string>
+#include <vector>
 
 namespace phosphor
 {
@@ -19,18 +27,29 @@ namespace monitor
 {
 
 /** @brief Assert or deassert an LED based on the input FRU
- *  @param[in] bus       -  The Dbus bus object
+ *  @param[in] client    -  Client of the LED group manager
  *  @param[in] path      -  Inventory path of the FRU
  *  @param[in] assert    -  Assert if true deassert if false
  */
-void action(sdbusplus::bus::bus& bus, const std::string& path, bool assert);
+void action(GroupClient& client, const std::string& path, bool assert);
 
-class Remove;
+/** @brief Assert or deassert the LEDs of several FRUs in one update
+ *  @param[in] client    -  Client of the LED group manager
+ *  @param[in] paths     -  Inventory paths of the FRUs
+ *  @param[in] assert    -  Assert if true deassert if false
+ */
+void action(GroupClient& client, const std::set<std::string>& paths,
+            bool assert);
 
 /** @class Add
  *  @brief Implementation of LED handling during FRU fault
  *  @details This implements methods for watching for a FRU fault
- *  being logged to assert the corresponding LED
+ *  being logged to assert the corresponding LED, and for the resolution
+ *  of the fault to deassert it. A single match on the logging namespace
+ *  is used for each. A log entry is resolved either by deleting it or by
+ *  marking it Resolved, which clears its associations, so the association
+ *  changes of the entries are watched too. The open entries are counted
+ *  per FRU, see FaultIndex.
  */
 class Add
 {
@@ -43,90 +62,91 @@ class Add
     Add& operator=(Add&&) = default;
 
     /** @brief constructs Add a watch for FRU faults.
-     *  @param[in] bus -  The Dbus bus object
+     *  @param[in] bus    -  The Dbus bus object
+     *  @param[in] event  -  The event loop
+     *  @param[in] window -  Time over which the LED changes are batched
+     *  @param[in] sink   -  Applies the LED changes in process, if set
+     *  @param[in] groups -  Paths of the groups defined by the manager,
+     *                       with a sink
      */
-    explicit Add(sdbusplus::bus::bus& bus) :
+    Add(sdbusplus::bus::bus& bus, const sdeventplus::Event& event,
+        std::chrono::milliseconds window, GroupSink sink = {},
+        const std::vector<std::string>& groups = {}) :
+        client(bus, event, window, std::move(sink), groups),
         matchCreated(
             bus,
             sdbusplus::bus::match::rules::interfacesAdded() +
                 sdbusplus::bus::match::rules::path_namespace(
                     "/xyz/openbmc_project/logging"),
-            std::bind(std::mem_fn(&Add::created), this, std::placeholders::_1))
+            std::bind(std::mem_fn(&Add::created), this, std::placeholders::_1)),
+        matchRemoved(
+            bus,
+            sdbusplus::bus::match::rules::interfacesRemoved() +
+                sdbusplus::bus::match::rules::path_namespace(
+                    "/xyz/openbmc_project/logging"),
+            std::bind(std::mem_fn(&Add::removed), this, std::placeholders::_1)),
+        matchChanged(
+            bus,
+            sdbusplus::bus::match::rules::propertiesChangedNamespace(
+                "/xyz/openbmc_project/logging",
+                "xyz.openbmc_project.Association.Definitions"),
+            std::bind(std::mem_fn(&Add::changed), this, std::placeholders::_1))
     {
         processExistingCallouts(bus);
     }
 
+    /** @brief Logs the counters of the LED group changes */
+    inline void logStats() const
+    {
+        client.logStats();
+    }
+
   private:
+    /** @brief Client of the LED group manager */
+    GroupClient client;
+
     /** @brief sdbusplus signal match for fault created */
     sdbusplus::bus::match_t matchCreated;
 
-    std::vector<std::unique_ptr<Remove>> removeWatches;
+    /** @brief sdbusplus signal match for fault removed */
+    sdbusplus::bus::match_t matchRemoved;
+
+    /** @brief sdbusplus signal match for the callouts changes */
+    sdbusplus::bus::match_t matchChanged;
+
+    /** @brief The open log entries and their callouts */
+    FaultIndex index;
 
     /** @brief Callback function for fru fault created
      *  @param[in] msg       - Data associated with subscribed signal
      */
     void created(sdbusplus::message::message& msg);
 
-    /** @brief This function process all callouts at application start
-     *  @param[in] bus - The Dbus bus object
-     */
-    void processExistingCallouts(sdbusplus::bus::bus& bus);
-};
-
-/** @class Remove
- *  @brief Implementation of LED handling after resolution of FRU fault
- *  @details Implement methods for watching the resolution of FRU faults
- *  and deasserting corresponding LED.
- */
-class Remove
-{
-  public:
-    Remove() = delete;
-    ~Remove() = default;
-    Remove(const Remove&) = delete;
-    Remove& operator=(const Remove&) = delete;
-    Remove(Remove&&) = default;
-    Remove& operator=(Remove&&) = default;
-
-    /** @brief constructs Remove
-     *  @param[in] bus  -  The Dbus bus object
-     *  @param[in] path -  Inventory path to fru
-     */
-    Remove(sdbusplus::bus::bus& bus, const std::string& path) :
-        inventoryPath(path),
-        matchRemoved(bus, match(path),
-                     std::bind(std::mem_fn(&Remove::removed), this,
-                               std::placeholders::_1))
-    {
-        // Do nothing
-    }
-
-  private:
-    /** @brief inventory path of the FRU */
-    std::string inventoryPath;
-
-    /** @brief sdbusplus signal matches for fault removed */
-    sdbusplus::bus::match_t matchRemoved;
-
-    /** @brief Callback function for fru fault created
+    /** @brief Callback function for fru fault resolved
      *  @param[in] msg       - Data associated with subscribed signal
      */
     void removed(sdbusplus::message::message& msg);
 
-    /** @brief function to create fault remove match for a fru
-     *  @param[in] path  - Inventory path of the faulty unit.
+    /** @brief Callback function for the callouts changes of a log entry,
+     *         cleared when it is resolved
+     *  @param[in] msg       - Data associated with subscribed signal
      */
-    std::string match(const std::string& path)
-    {
-        namespace MatchRules = sdbusplus::bus::match::rules;
+    void changed(sdbusplus::message::message& msg);
 
-        std::string matchStmt =
-            MatchRules::interfacesRemoved() +
-            MatchRules::argNpath(0, path + "/" + CALLOUT_REV_ASSOCIATION);
+    /** @brief Applies the fault LED changes of a log entry update
+     *  @param[in] changes - The FRUs whose fault LED changes
+     */
+    void apply(const FaultChanges& changes);
 
-        return matchStmt;
-    }
+    /** @brief This function process all callouts at application start
+     *  @details The logging entries are read with one GetManagedObjects on
+     *           the logging service and the LEDs of all the faulted FRUs are
+     *           asserted with one batched update.
+     *  @param[in] bus - The Dbus bus object
+     */
+    void processExistingCallouts(sdbusplus::bus::bus& bus);
 };
+
 } // namespace monitor
 } // namespace fault
 } // namespace fru
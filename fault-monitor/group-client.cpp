@@ -0,0 +1,399 @@
+#include "config.h"
+
+#include "group-client.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/exception.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace phosphor
+{
+namespace led
+{
+namespace fru
+{
+namespace fault
+{
+namespace monitor
+{
+
+constexpr auto DBUS_BUSNAME = "org.freedesktop.DBus";
+constexpr auto DBUS_OBJ_PATH = "/org/freedesktop/DBus";
+constexpr auto DBUS_IFACE = "org.freedesktop.DBus";
+constexpr auto PROPERTY_IFACE = "org.freedesktop.DBus.Properties";
+constexpr auto OBJMGR_IFACE = "org.freedesktop.DBus.ObjectManager";
+constexpr auto GROUP_IFACE = "xyz.openbmc_project.Led.Group";
+constexpr auto GROUP_MANAGER_IFACE = "xyz.openbmc_project.Led.GroupManager";
+
+GroupClient::GroupClient(sdbusplus::bus::bus& bus,
+                         const sdeventplus::Event& event,
+                         std::chrono::milliseconds window, GroupSink sink,
+                         const std::vector<std::string>& groups) :
+    bus(bus),
+    sink(std::move(sink)), window(window),
+    timer(event, std::bind(std::mem_fn(&GroupClient::flush), this))
+{
+    if (this->sink)
+    {
+        // The manager is in this process, with a fixed set of groups
+        this->groups.insert(groups.begin(), groups.end());
+        groupsKnown = true;
+        return;
+    }
+
+    matchOwner = std::make_unique<sdbusplus::bus::match_t>(
+        bus, sdbusplus::bus::match::rules::nameOwnerChanged(BUSNAME),
+        std::bind(std::mem_fn(&GroupClient::ownerChanged), this,
+                  std::placeholders::_1));
+    matchAdded = std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        sdbusplus::bus::match::rules::interfacesAdded() +
+            sdbusplus::bus::match::rules::path_namespace(OBJPATH) +
+            sdbusplus::bus::match::rules::sender(BUSNAME),
+        std::bind(std::mem_fn(&GroupClient::groupsAdded), this,
+                  std::placeholders::_1));
+    matchRemoved = std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        sdbusplus::bus::match::rules::interfacesRemoved() +
+            sdbusplus::bus::match::rules::path_namespace(OBJPATH) +
+            sdbusplus::bus::match::rules::sender(BUSNAME),
+        std::bind(std::mem_fn(&GroupClient::groupsRemoved), this,
+                  std::placeholders::_1));
+    matchChanged = std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        sdbusplus::bus::match::rules::type::signal() +
+            sdbusplus::bus::match::rules::member("GroupsChanged") +
+            sdbusplus::bus::match::rules::path(OBJPATH) +
+            sdbusplus::bus::match::rules::interface(GROUP_MANAGER_IFACE) +
+            sdbusplus::bus::match::rules::sender(BUSNAME),
+        std::bind(std::mem_fn(&GroupClient::groupsChanged), this,
+                  std::placeholders::_1));
+
+    // The matches are in place first, so no change can be missed
+    owner = getOwner();
+    loadGroups();
+}
+
+void GroupClient::loadGroups()
+{
+    groups.clear();
+    groupsKnown = false;
+
+    if (owner.empty())
+    {
+        return;
+    }
+
+    using Properties = std::map<std::string, std::variant<bool>>;
+    using Interfaces = std::map<std::string, Properties>;
+    std::map<sdbusplus::message::object_path, Interfaces> objects;
+    try
+    {
+        auto method = bus.new_method_call(owner.c_str(), OBJPATH,
+                                          OBJMGR_IFACE, "GetManagedObjects");
+        auto reply = bus.call(method);
+        reply.read(objects);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to get the LED groups, ERROR = {ERROR}", "ERROR",
+                   e);
+        return;
+    }
+
+    for (const auto& [path, interfaces] : objects)
+    {
+        if (interfaces.contains(GROUP_IFACE))
+        {
+            groups.emplace(path.str);
+        }
+    }
+    groupsKnown = true;
+}
+
+void GroupClient::groupsAdded(sdbusplus::message::message& msg)
+{
+    sdbusplus::message::object_path path;
+    std::map<std::string, std::map<std::string, std::variant<bool>>>
+        interfaces;
+    try
+    {
+        msg.read(path, interfaces);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse InterfacesAdded message, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
+
+    if (interfaces.contains(GROUP_IFACE))
+    {
+        groups.emplace(path.str);
+    }
+}
+
+void GroupClient::groupsRemoved(sdbusplus::message::message& msg)
+{
+    sdbusplus::message::object_path path;
+    std::vector<std::string> interfaces;
+    try
+    {
+        msg.read(path, interfaces);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error(
+            "Failed to parse InterfacesRemoved message, ERROR = {ERROR}",
+            "ERROR", e);
+        return;
+    }
+
+    if (std::ranges::find(interfaces, GROUP_IFACE) != interfaces.end())
+    {
+        groups.erase(path.str);
+    }
+}
+
+void GroupClient::groupsChanged(sdbusplus::message::message& msg)
+{
+    std::vector<std::tuple<sdbusplus::message::object_path, bool>> changes;
+    try
+    {
+        msg.read(changes);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse GroupsChanged message, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
+
+    for (const auto& [path, assert] : changes)
+    {
+        sent.insert_or_assign(path.str, assert);
+    }
+}
+
+std::string GroupClient::getOwner()
+{
+    auto method = bus.new_method_call(DBUS_BUSNAME, DBUS_OBJ_PATH, DBUS_IFACE,
+                                      "GetNameOwner");
+    method.append(BUSNAME);
+
+    std::string name;
+    try
+    {
+        auto reply = bus.call(method);
+        reply.read(name);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        // The LED manager is not started yet
+        lg2::info("LED group manager is not on the bus, ERROR = {ERROR}",
+                  "ERROR", e);
+    }
+
+    return name;
+}
+
+void GroupClient::ownerChanged(sdbusplus::message::message& msg)
+{
+    std::string name;
+    std::string oldOwner;
+    std::string newOwner;
+    try
+    {
+        msg.read(name, oldOwner, newOwner);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse NameOwnerChanged message, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
+
+    // A new manager starts from its own saved state
+    owner = newOwner;
+    sent.clear();
+    loadGroups();
+    if (owner.empty() || pending.empty())
+    {
+        return;
+    }
+
+    lg2::info("LED group manager is up, sending {COUNT} queued groups",
+              "COUNT", pending.size());
+    flush();
+}
+
+void GroupClient::set(const std::string& path, bool assert)
+{
+    queue(path, assert);
+    schedule();
+}
+
+void GroupClient::set(const std::map<std::string, bool>& groups)
+{
+    for (const auto& [path, assert] : groups)
+    {
+        queue(path, assert);
+    }
+    schedule();
+}
+
+void GroupClient::queue(const std::string& path, bool assert)
+{
+    if (!pending.insert_or_assign(path, assert).second)
+    {
+        ++coalesced;
+    }
+}
+
+void GroupClient::schedule()
+{
+    if (owner.empty() && !sink)
+    {
+        // Sent when the manager shows up
+        return;
+    }
+
+    if (window.count() == 0)
+    {
+        flush();
+    }
+    else if (!timer.isEnabled())
+    {
+        timer.restartOnce(window);
+    }
+}
+
+void GroupClient::flush()
+{
+    if (owner.empty() && !sink)
+    {
+        return;
+    }
+
+    std::map<std::string, bool> changes;
+    for (const auto& [path, assert] : pending)
+    {
+        if (groupsKnown && !groups.contains(path))
+        {
+            // Not all the FRUs have a fault LED group
+            ++skipped;
+            continue;
+        }
+
+        auto iter = sent.find(path);
+        if (!sink && iter != sent.end() && iter->second == assert)
+        {
+            ++dropped;
+            continue;
+        }
+        changes.emplace(path, assert);
+    }
+    pending.clear();
+
+    if (changes.empty())
+    {
+        return;
+    }
+
+    lg2::debug("Sending {COUNT} LED groups, COALESCED = {COALESCED}, "
+               "DROPPED = {DROPPED}, SKIPPED = {SKIPPED}",
+               "COUNT", changes.size(), "COALESCED", coalesced, "DROPPED",
+               dropped, "SKIPPED", skipped);
+
+    if (sink)
+    {
+        sink(changes);
+        return;
+    }
+
+    auto done = changes.size() == 1
+                    ? setGroup(changes.begin()->first, changes.begin()->second)
+                    : setGroups(changes);
+    if (!done)
+    {
+        // Sent again by the next change, whatever the value
+        for (const auto& [path, assert] : changes)
+        {
+            sent.erase(path);
+        }
+        return;
+    }
+
+    for (const auto& [path, assert] : changes)
+    {
+        sent.insert_or_assign(path, assert);
+    }
+}
+
+void GroupClient::logStats() const
+{
+    lg2::info("LED group changes not sent, COALESCED = {COALESCED}, "
+              "DROPPED = {DROPPED}, SKIPPED = {SKIPPED}",
+              "COALESCED", coalesced, "DROPPED", dropped, "SKIPPED", skipped);
+}
+
+bool GroupClient::setGroup(const std::string& path, bool assert)
+{
+    auto method = bus.new_method_call(owner.c_str(), path.c_str(),
+                                      PROPERTY_IFACE, "Set");
+    method.append(GROUP_IFACE);
+    method.append("Asserted");
+    method.append(std::variant<bool>(assert));
+
+    try
+    {
+        bus.call_noreply(method);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        // Log an info message, system may not have all the LED Groups defined
+        lg2::info("Failed to Assert LED Group, ERROR = {ERROR}", "ERROR", e);
+        return false;
+    }
+
+    return true;
+}
+
+bool GroupClient::setGroups(const std::map<std::string, bool>& groups)
+{
+    std::map<sdbusplus::message::object_path, bool> paths;
+    for (const auto& [path, assert] : groups)
+    {
+        paths.emplace(path, assert);
+    }
+
+    // The LED manager ignores the groups it does not define
+    auto method = bus.new_method_call(owner.c_str(), OBJPATH,
+                                      GROUP_MANAGER_IFACE, "SetGroups");
+    method.append(paths);
+
+    try
+    {
+        bus.call_noreply(method);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to set the LED groups, ERROR = {ERROR}", "ERROR",
+                   e);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace monitor
+} // namespace fault
+} // namespace fru
+} // namespace led
+} // namespace phosphor
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "group-sink.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace phosphor
+{
+namespace led
+{
+namespace fru
+{
+namespace fault
+{
+namespace monitor
+{
+
+/** @class GroupClient
+ *  @brief Sets the LED groups hosted by the LED group manager
+ *  @details The bus name of the manager is resolved once and then tracked
+ *           with a NameOwnerChanged match. Changes are collected over a
+ *           batch window, the latest value of a group wins, and sent as one
+ *           update when the window ends. The values of the groups are
+ *           tracked from the replies and from the GroupsChanged signals of
+ *           the manager, so the changes made by others are seen too, and
+ *           the changes that end up at the current value are dropped.
+ *           While the manager is not on the bus the changes are kept and
+ *           sent when it shows up.
+ *
+ *           The groups defined by the manager are fetched when it shows up
+ *           and kept current with its InterfacesAdded/Removed signals, so
+ *           changes of groups it does not define are skipped without a call.
+ *
+ *           When a sink is given, the monitor runs inside the LED manager
+ *           and the changes are handed to the sink instead. The manager
+ *           is then not watched, its groups are given along with the sink,
+ *           and it skips the unchanged groups itself, so nothing is
+ *           dropped.
+ */
+class GroupClient
+{
+  public:
+    GroupClient() = delete;
+    ~GroupClient() = default;
+    GroupClient(const GroupClient&) = delete;
+    GroupClient& operator=(const GroupClient&) = delete;
+    GroupClient(GroupClient&&) = delete;
+    GroupClient& operator=(GroupClient&&) = delete;
+
+    /** @brief Starts tracking the LED group manager
+     *  @param[in] bus    - The Dbus bus object
+     *  @param[in] event  - The event loop running the batch timer
+     *  @param[in] window - Time over which the changes are collected, zero
+     *                      sends each change right away
+     *  @param[in] sink   - Applies the changes in process, if set
+     *  @param[in] groups - Paths of the groups defined by the manager, with
+     *                      a sink
+     */
+    GroupClient(sdbusplus::bus::bus& bus, const sdeventplus::Event& event,
+                std::chrono::milliseconds window, GroupSink sink = {},
+                const std::vector<std::string>& groups = {});
+
+    /** @brief Sets the Asserted property of a group
+     *  @param[in] path   - D-Bus path of the LED group
+     *  @param[in] assert - Assert if true deassert if false
+     */
+    void set(const std::string& path, bool assert);
+
+    /** @brief Sets the Asserted property of several groups in one update
+     *  @param[in] groups - Map of LED group path to Asserted value
+     */
+    void set(const std::map<std::string, bool>& groups);
+
+    /** @brief Number of changes overwritten by a later change of the same
+     *         group within the batch window
+     */
+    inline uint64_t getCoalesced() const
+    {
+        return coalesced;
+    }
+
+    /** @brief Number of changes not sent since the group was already at
+     *         the requested value
+     */
+    inline uint64_t getDropped() const
+    {
+        return dropped;
+    }
+
+    /** @brief Number of changes not sent since the manager does not define
+     *         the group
+     */
+    inline uint64_t getSkipped() const
+    {
+        return skipped;
+    }
+
+    /** @brief Logs the counters of the changes not sent */
+    void logStats() const;
+
+  private:
+    /** @brief The Dbus bus object */
+    sdbusplus::bus::bus& bus;
+
+    /** @brief Applies the changes in process, if set */
+    GroupSink sink;
+
+    /** @brief Unique bus name of the manager, empty while it is absent */
+    std::string owner;
+
+    /** @brief Time over which the changes are collected */
+    std::chrono::milliseconds window;
+
+    /** @brief Changes waiting for the end of the batch window, or for the
+     *         manager to show up
+     */
+    std::map<std::string, bool> pending;
+
+    /** @brief Value of the groups on the current manager, as last set
+     *         successfully or signaled
+     */
+    std::unordered_map<std::string, bool> sent;
+
+    /** @brief Changes overwritten within the batch window */
+    uint64_t coalesced = 0;
+
+    /** @brief Changes already matching the value of the group */
+    uint64_t dropped = 0;
+
+    /** @brief Groups defined by the current manager */
+    std::unordered_set<std::string> groups;
+
+    /** @brief Whether the groups of the current manager could be fetched,
+     *         nothing is skipped otherwise
+     */
+    bool groupsKnown = false;
+
+    /** @brief Changes of groups the manager does not define */
+    uint64_t skipped = 0;
+
+    /** @brief Timer ending the batch window */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+
+    /** @brief sdbusplus signal match for the manager owner changes */
+    std::unique_ptr<sdbusplus::bus::match_t> matchOwner;
+
+    /** @brief sdbusplus signal match for groups added to the manager */
+    std::unique_ptr<sdbusplus::bus::match_t> matchAdded;
+
+    /** @brief sdbusplus signal match for groups removed from the manager */
+    std::unique_ptr<sdbusplus::bus::match_t> matchRemoved;
+
+    /** @brief sdbusplus signal match for the group changes of the manager */
+    std::unique_ptr<sdbusplus::bus::match_t> matchChanged;
+
+    /** @brief Callback function for the manager owner changes
+     *  @param[in] msg - Data associated with subscribed signal
+     */
+    void ownerChanged(sdbusplus::message::message& msg);
+
+    /** @brief Callback function for groups added to the manager
+     *  @param[in] msg - Data associated with subscribed signal
+     */
+    void groupsAdded(sdbusplus::message::message& msg);
+
+    /** @brief Callback function for groups removed from the manager
+     *  @param[in] msg - Data associated with subscribed signal
+     */
+    void groupsRemoved(sdbusplus::message::message& msg);
+
+    /** @brief Callback function for the group changes of the manager,
+     *         whoever made them
+     *  @param[in] msg - Data associated with subscribed signal
+     */
+    void groupsChanged(sdbusplus::message::message& msg);
+
+    /** @brief Fetches the groups defined by the current manager */
+    void loadGroups();
+
+    /** @brief Queues a change, replacing a queued change of the group
+     *  @param[in] path   - D-Bus path of the LED group
+     *  @param[in] assert - Assert if true deassert if false
+     */
+    void queue(const std::string& path, bool assert);
+
+    /** @brief Arms the batch window, or flushes right away without one */
+    void schedule();
+
+    /** @brief Sends the queued changes if the manager is on the bus */
+    void flush();
+
+    /** @brief Returns the current owner of the manager bus name
+     *  @return the unique bus name, empty if the name has no owner
+     */
+    std::string getOwner();
+
+    /** @brief Sends one group change with a property Set
+     *  @param[in] path   - D-Bus path of the LED group
+     *  @param[in] assert - Assert if true deassert if false
+     *  @return true if the group was set
+     */
+    bool setGroup(const std::string& path, bool assert);
+
+    /** @brief Sends several group changes with the SetGroups method
+     *  @param[in] groups - Map of LED group path to Asserted value
+     *  @return true if the groups were set
+     */
+    bool setGroups(const std::map<std::string, bool>& groups);
+};
+
+} // namespace monitor
+} // namespace fault
+} // namespace fru
+} // namespace led
+} // namespace phosphor
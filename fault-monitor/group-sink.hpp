@@ -0,0 +1,19 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+
+namespace phosphor
+{
+namespace led
+{
+
+/** @brief Applies LED group changes without going through D-Bus, when the
+ *         monitors run inside the LED manager. Takes a map of LED group
+ *         path to Asserted value.
+ */
+using GroupSink = std::function<void(const std::map<std::string, bool>&)>;
+
+} // namespace led
+} // namespace phosphor
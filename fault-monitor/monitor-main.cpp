@@ -1,27 +1,106 @@
 #include "config.h"
 
-#ifdef MONITOR_OPERATIONAL_STATUS
-#include "operational-status-monitor.hpp"
-#else
 #include "fru-fault-monitor.hpp"
-#endif
+#include "operational-status-monitor.hpp"
+#include "utils.hpp"
+
+#include <CLI/CLI.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
 
-int main(void)
+#include <chrono>
+#include <memory>
+
+int main(int argc, char** argv)
 {
-    /** @brief Dbus constructs used by Fault Monitor */
-    sdbusplus::bus::bus bus = sdbusplus::bus::new_default();
+    CLI::App app("phosphor-fru-fault-monitor");
 
+    bool callouts = false;
+    app.add_flag("--callouts", callouts,
+                 "Assert the fault LEDs of the FRUs called out by error logs");
+
+    bool operationalStatus = false;
+    app.add_flag("--operational-status", operationalStatus,
+                 "Assert the fault LEDs of the FRUs that are not functional");
+
+    unsigned int batchWindow = 100;
+    app.add_option("--batch-window", batchWindow,
+                   "Milliseconds over which fault LED changes are collected "
+                   "and sent as one update, 0 sends each change right away");
+
+    unsigned int holdTime = 1000;
+    app.add_option("--functional-hold-time", holdTime,
+                   "Milliseconds the Functional property has to stay "
+                   "unchanged before its LEDs are updated, 0 updates them on "
+                   "each change");
+
+    unsigned int statsInterval = 3600;
+    app.add_option("--stats-interval", statsInterval,
+                   "Seconds between the logs of the counters, 0 disables "
+                   "them");
+
+    CLI11_PARSE(app, argc, argv);
+
+    // Without a selection, run the monitor picked at build time
+    if (!callouts && !operationalStatus)
+    {
 #ifdef MONITOR_OPERATIONAL_STATUS
-    phosphor::led::Operational::status::monitor::Monitor monitor(bus);
+        operationalStatus = true;
 #else
-    phosphor::led::fru::fault::monitor::Add monitor(bus);
+        callouts = true;
 #endif
-    /** @brief Wait for client requests */
-    while (true)
+    }
+
+    // Get a default event loop
+    auto event = sdeventplus::Event::get_default();
+
+    /** @brief Dbus constructs used by Fault Monitor */
+    auto& bus = phosphor::led::utils::DBusHandler::getBus();
+
+    std::unique_ptr<phosphor::led::fru::fault::monitor::Add> calloutMonitor;
+    if (callouts)
     {
-        /** @brief process dbus calls / signals discarding unhandled */
-        bus.process_discard();
-        bus.wait();
+        calloutMonitor =
+            std::make_unique<phosphor::led::fru::fault::monitor::Add>(
+                bus, event, std::chrono::milliseconds(batchWindow));
     }
-    return 0;
+
+    std::unique_ptr<phosphor::led::Operational::status::monitor::Monitor>
+        statusMonitor;
+    if (operationalStatus)
+    {
+        statusMonitor = std::make_unique<
+            phosphor::led::Operational::status::monitor::Monitor>(
+            bus, event, std::chrono::milliseconds(holdTime),
+            std::chrono::milliseconds(batchWindow));
+    }
+
+    // Logs the counters periodically
+    using Timer = sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>;
+    std::unique_ptr<Timer> statsTimer;
+    if (statsInterval != 0)
+    {
+        statsTimer = std::make_unique<Timer>(
+            event,
+            [&calloutMonitor, &statusMonitor](auto&) {
+                if (calloutMonitor)
+                {
+                    calloutMonitor->logStats();
+                }
+                if (statusMonitor)
+                {
+                    statusMonitor->logStats();
+                }
+                phosphor::led::utils::DBusHandler::getServiceCache()
+                    .logStats();
+            },
+            std::chrono::seconds(statsInterval));
+    }
+
+    // The signals are dispatched ahead of the timers, so a batch window only
+    // ends once the queued signals have been folded into it.
+    bus.attach_event(event.get(), SD_EVENT_PRIORITY_IMPORTANT);
+
+    /** @brief Wait for client requests */
+    return event.loop();
 }
@@ -1,8 +1,19 @@
+#include "config.h"
+
 #include "operational-status-monitor.hpp"
 
 #include <phosphor-logging/elog.hpp>
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <variant>
+
 namespace phosphor
 {
 namespace led
@@ -38,73 +49,396 @@ void Monitor::matchHandler(sdbusplus::message::message& msg)
             return;
         }
 
-        // See if the Inventory D-Bus object has an association with LED groups
-        // D-Bus object.
-        auto ledGroupPath = getLedGroupPaths(invObjectPath);
-        if (ledGroupPath.empty())
+        debounce(invObjectPath, *value);
+    }
+}
+
+void Monitor::debounce(const std::string& inventoryPath, bool value)
+{
+    if (holdTime.count() == 0)
+    {
+        apply(inventoryPath, value);
+        return;
+    }
+
+    // Each edge restarts the hold time, only the settled value is applied
+    auto deadline = std::chrono::steady_clock::now() + holdTime;
+    auto [it, inserted] =
+        unsettled.try_emplace(inventoryPath, Unsettled{value, deadline, 0});
+    if (!inserted)
+    {
+        it->second.value = value;
+        it->second.deadline = deadline;
+        ++it->second.suppressed;
+        ++suppressed;
+    }
+
+    if (!timer.isEnabled())
+    {
+        timer.restartOnce(holdTime);
+    }
+}
+
+void Monitor::settle()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::optional<std::chrono::steady_clock::time_point> next;
+
+    for (auto it = unsettled.begin(); it != unsettled.end();)
+    {
+        if (it->second.deadline > now)
         {
-            lg2::info(
-                "The inventory D-Bus object is not associated with the LED "
-                "group D-Bus object. INVENTORY_PATH = {PATH}",
-                "PATH", invObjectPath);
+            if (!next || it->second.deadline < *next)
+            {
+                next = it->second.deadline;
+            }
+            ++it;
+            continue;
+        }
+
+        if (it->second.suppressed != 0)
+        {
+            lg2::debug("Functional settled, SUPPRESSED = {SUPPRESSED}, "
+                       "INVENTORY_PATH = {PATH}",
+                       "SUPPRESSED", it->second.suppressed, "PATH",
+                       it->first);
+        }
+
+        apply(it->first, it->second.value);
+        it = unsettled.erase(it);
+    }
+
+    if (next)
+    {
+        timer.restartOnce(
+            std::chrono::ceil<std::chrono::milliseconds>(*next - now));
+    }
+}
+
+void Monitor::apply(const std::string& inventoryPath, bool value)
+{
+    // Flapping back to the value already applied needs no update
+    auto [it, inserted] = functional.try_emplace(inventoryPath, value);
+    if (!inserted)
+    {
+        if (it->second == value)
+        {
+            ++suppressed;
             return;
         }
+        it->second = value;
+    }
+
+    // See if the Inventory D-Bus object has an association with LED groups
+    // D-Bus object.
+    auto ledGroupPath = getLedGroupPaths(inventoryPath);
+    if (ledGroupPath.empty())
+    {
+        lg2::info("The inventory D-Bus object is not associated with the LED "
+                  "group D-Bus object. INVENTORY_PATH = {PATH}",
+                  "PATH", inventoryPath);
+        return;
+    }
+
+    // Update the Asserted property by the Functional property value.
+    updateAssertedProperty(ledGroupPath, value);
+}
+
+namespace
+{
 
-        // Update the Asserted property by the Functional property value.
-        updateAssertedProperty(ledGroupPath, *value);
+/** @brief Returns the inventory D-Bus object path of a "fault_led_group"
+ *         association object path, empty for any other path
+ */
+std::string getInventoryPath(const std::string& assocPath)
+{
+    constexpr std::string_view suffix = "/fault_led_group";
+    if (!assocPath.ends_with(suffix))
+    {
+        return {};
     }
+
+    return assocPath.substr(0, assocPath.size() - suffix.size());
 }
 
+} // namespace
+
 const std::vector<std::string>
     Monitor::getLedGroupPaths(const std::string& inventoryPath) const
 {
-    // Get endpoints from the rType
-    std::string faultLedAssociation = inventoryPath + "/fault_led_group";
+    auto it = ledGroups.find(inventoryPath);
+    if (it == ledGroups.end())
+    {
+        return {};
+    }
+
+    return it->second;
+}
+
+void Monitor::loadAssociations()
+{
+    dBusHandler.getSubTreePaths(
+        INVENTORY_PATH, ASSOCIATION_IFACE,
+        [this](int ec, const std::vector<std::string>& paths) {
+            if (ec < 0)
+            {
+                lg2::error(
+                    "Failed to get the association paths, ERROR = {ERROR}",
+                    "ERROR", strerror(-ec));
+                reconcile();
+                return;
+            }
+
+            // The extra count keeps reconcile from running before all the
+            // calls are sent
+            auto pending = std::make_shared<size_t>(1);
+            auto complete = [this, pending]() {
+                if (--*pending == 0)
+                {
+                    reconcile();
+                }
+            };
+
+            for (const auto& path : paths)
+            {
+                auto inventoryPath = getInventoryPath(path);
+                if (inventoryPath.empty())
+                {
+                    continue;
+                }
 
-    // endpoint contains the vector of strings, where each string is a Inventory
-    // D-Bus object that this, associated with this LED Group D-Bus object
-    // pointed to by fru_fault
-    PropertyValue endpoint{};
+                // endpoint contains the vector of strings, where each string
+                // is a LED Group D-Bus object associated with this Inventory
+                // D-Bus object
+                auto method = bus.new_method_call(
+                    MAPPER_BUSNAME, path.c_str(), DBUS_PROPERTY_IFACE, "Get");
+                method.append(ASSOCIATION_IFACE, "endpoints");
 
+                ++*pending;
+                dBusHandler.call(
+                    method, [this, path, inventoryPath,
+                             complete](int ec,
+                                       sdbusplus::message::message& reply) {
+                        if (ec < 0)
+                        {
+                            lg2::error(
+                                "Failed to get endpoints property, ERROR = {ERROR}, PATH = {PATH}",
+                                "ERROR", strerror(-ec), "PATH", path);
+                            complete();
+                            return;
+                        }
+
+                        try
+                        {
+                            std::variant<std::vector<std::string>> endpoints;
+                            reply.read(endpoints);
+
+                            ledGroups.insert_or_assign(
+                                inventoryPath,
+                                std::get<std::vector<std::string>>(
+                                    std::move(endpoints)));
+                        }
+                        catch (const sdbusplus::exception::exception& e)
+                        {
+                            lg2::error(
+                                "Failed to get endpoints property, ERROR = {ERROR}, PATH = {PATH}",
+                                "ERROR", e, "PATH", path);
+                        }
+                        complete();
+                    });
+            }
+
+            complete();
+        });
+}
+
+void Monitor::reconcile()
+{
+    auto method = bus.new_method_call(INVENTORY_BUSNAME, INVENTORY_PATH,
+                                      "org.freedesktop.DBus.ObjectManager",
+                                      "GetManagedObjects");
+    dBusHandler.call(method, [this](int ec,
+                                    sdbusplus::message::message& reply) {
+        if (ec < 0)
+        {
+            lg2::error("Failed to get the inventory objects, ERROR = {ERROR}",
+                       "ERROR", strerror(-ec));
+            return;
+        }
+        reconcile(reply);
+    });
+}
+
+void Monitor::reconcile(sdbusplus::message::message& reply)
+{
+    using Properties = std::unordered_map<std::string, std::variant<bool>>;
+    using Interfaces = std::unordered_map<std::string, Properties>;
+    std::map<sdbusplus::message::object_path, Interfaces> objects;
     try
     {
-        endpoint = dBusHandler.getProperty(faultLedAssociation,
-                                           "xyz.openbmc_project.Association",
-                                           "endpoints");
+        reply.read(objects);
     }
     catch (const sdbusplus::exception::exception& e)
     {
-        lg2::error(
-            "Failed to get endpoints property, ERROR = {ERROR}, PATH = {PATH}",
-            "ERROR", e, "PATH", faultLedAssociation);
+        lg2::error("Failed to get the inventory objects, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
 
-        return {};
+    // Only the groups of the FRUs that are not functional are asserted. The
+    // others are left alone, their fault group may be asserted by a callout
+    std::map<std::string, bool> groups;
+    for (const auto& [path, interfaces] : objects)
+    {
+        auto iface = interfaces.find(OPERATIONAL_STATUS_IFACE);
+        if (iface == interfaces.end())
+        {
+            continue;
+        }
+
+        auto it = iface->second.find("Functional");
+        if (it == iface->second.end())
+        {
+            continue;
+        }
+
+        const bool* value = std::get_if<bool>(&it->second);
+        if (!value)
+        {
+            continue;
+        }
+
+        functional.insert_or_assign(path.str, *value);
+        if (*value)
+        {
+            continue;
+        }
+
+        for (const auto& group : getLedGroupPaths(path.str))
+        {
+            groups.insert_or_assign(group, true);
+        }
     }
 
-    return std::get<std::vector<std::string>>(endpoint);
+    if (!groups.empty())
+    {
+        client.set(groups);
+    }
+}
+
+void Monitor::assocChanged(sdbusplus::message::message& msg)
+{
+    auto inventoryPath = getInventoryPath(msg.get_path());
+    if (inventoryPath.empty())
+    {
+        return;
+    }
+
+    std::string interfaceName{};
+    std::unordered_map<std::string, std::variant<std::vector<std::string>>>
+        properties;
+    try
+    {
+        msg.read(interfaceName, properties);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse association change, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
+
+    auto it = properties.find("endpoints");
+    if (it != properties.end())
+    {
+        ledGroups.insert_or_assign(
+            inventoryPath, std::get<std::vector<std::string>>(it->second));
+    }
+}
+
+void Monitor::assocAdded(sdbusplus::message::message& msg)
+{
+    sdbusplus::message::object_path objectPath;
+    std::unordered_map<
+        std::string,
+        std::unordered_map<std::string,
+                           std::variant<std::vector<std::string>>>>
+        interfaces;
+    try
+    {
+        msg.read(objectPath, interfaces);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse association added, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
+
+    auto inventoryPath = getInventoryPath(objectPath.str);
+    if (inventoryPath.empty())
+    {
+        return;
+    }
+
+    auto iface = interfaces.find(ASSOCIATION_IFACE);
+    if (iface == interfaces.end())
+    {
+        return;
+    }
+
+    auto it = iface->second.find("endpoints");
+    if (it != iface->second.end())
+    {
+        ledGroups.insert_or_assign(
+            inventoryPath, std::get<std::vector<std::string>>(it->second));
+    }
+}
+
+void Monitor::assocRemoved(sdbusplus::message::message& msg)
+{
+    sdbusplus::message::object_path objectPath;
+    std::vector<std::string> interfaces;
+    try
+    {
+        msg.read(objectPath, interfaces);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse association removed, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
+
+    auto inventoryPath = getInventoryPath(objectPath.str);
+    if (inventoryPath.empty())
+    {
+        return;
+    }
+
+    if (std::ranges::find(interfaces, ASSOCIATION_IFACE) != interfaces.end())
+    {
+        ledGroups.erase(inventoryPath);
+    }
 }
 
 void Monitor::updateAssertedProperty(
     const std::vector<std::string>& ledGroupPaths, bool value)
 {
+    // Asserted is the opposite of Functional
+    std::map<std::string, bool> groups;
     for (const auto& path : ledGroupPaths)
     {
-        try
-        {
-            // Call "Group Asserted --> true" if the value of Functional is
-            // false Call "Group Asserted --> false" if the value of Functional
-            // is true
-            PropertyValue assertedValue{!value};
-            dBusHandler.setProperty(path, "xyz.openbmc_project.Led.Group",
-                                    "Asserted", assertedValue);
-        }
-        catch (const sdbusplus::exception::exception& e)
-        {
-            lg2::error(
-                "Failed to set Asserted property, ERROR = {ERROR}, PATH = {PATH}",
-                "ERROR", e, "PATH", path);
-        }
+        groups.emplace(path, !value);
     }
+    client.set(groups);
+}
+
+void Monitor::logStats() const
+{
+    lg2::info("Functional changes not applied, SUPPRESSED = {SUPPRESSED}",
+              "SUPPRESSED", suppressed);
+    client.logStats();
 }
 } // namespace monitor
 } // namespace status
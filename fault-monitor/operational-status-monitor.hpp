@@ -1,9 +1,19 @@
 #pragma once
 
 #include "../utils.hpp"
+#include "group-client.hpp"
+#include "group-sink.hpp"
 
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace phosphor
 {
@@ -17,6 +27,12 @@ namespace monitor
 {
 using namespace phosphor::led::utils;
 
+constexpr auto INVENTORY_PATH = "/xyz/openbmc_project/inventory";
+constexpr auto INVENTORY_BUSNAME = "xyz.openbmc_project.Inventory.Manager";
+constexpr auto OPERATIONAL_STATUS_IFACE =
+    "xyz.openbmc_project.State.Decorator.OperationalStatus";
+constexpr auto ASSOCIATION_IFACE = "xyz.openbmc_project.Association";
+
 /** @class Monitor
  *  @brief Implementation of LED handling during the change of the Functional
  *         property of the OperationalStatus interface
@@ -24,6 +40,20 @@ using namespace phosphor::led::utils;
  *  @details This implements methods for watching OperationalStatus interface of
  *           Inventory D-Bus object and then assert corresponding LED Group
  *           D-Bus objects.
+ *
+ *           The LED groups associated with each inventory object are read
+ *           from the mapper at startup and kept current by watching its
+ *           association objects, so a Functional change only costs the
+ *           update of the groups. At startup, the Functional property of all
+ *           the inventory objects is read at once and the groups of the
+ *           objects that are not functional are asserted as one batch. The
+ *           other groups are not deasserted, since the FRU fault monitor may
+ *           have asserted them. The groups are set through a GroupClient,
+ *           which batches the changes like for the FRU fault monitor.
+ *
+ *           Functional changes of an inventory object are debounced: each
+ *           edge restarts a hold time and only the value it settles to is
+ *           applied, if it differs from the value applied last.
  */
 class Monitor
 {
@@ -37,10 +67,25 @@ class Monitor
 
     /** @brief Add a watch for OperationalStatus.
      *
-     *  @param[in] bus -  D-Bus object
+     *  @param[in] bus      -  D-Bus object
+     *  @param[in] event    -  The event loop running the debounce timer
+     *  @param[in] holdTime -  Time the Functional property has to stay
+     *                         unchanged before it is applied, zero applies
+     *                         each change right away
+     *  @param[in] window   -  Time over which the LED group changes are
+     *                         batched
+     *  @param[in] sink     -  Applies the LED group changes in process, if set
+     *  @param[in] groups   -  Paths of the groups defined by the manager,
+     *                         with a sink
      */
-    explicit Monitor(sdbusplus::bus::bus& bus) :
+    Monitor(sdbusplus::bus::bus& bus, const sdeventplus::Event& event,
+            std::chrono::milliseconds holdTime,
+            std::chrono::milliseconds window, GroupSink sink = {},
+            const std::vector<std::string>& groups = {}) :
         bus(bus),
+        dBusHandler(bus), holdTime(holdTime),
+        client(bus, event, window, std::move(sink), groups),
+        timer(event, std::bind(std::mem_fn(&Monitor::settle), this)),
         matchSignal(bus,
                     "type='signal',member='PropertiesChanged', "
                     "interface='org.freedesktop.DBus.Properties', "
@@ -48,19 +93,85 @@ class Monitor
                     "arg0namespace='xyz.openbmc_project.State.Decorator."
                     "OperationalStatus'",
                     std::bind(std::mem_fn(&Monitor::matchHandler), this,
-                              std::placeholders::_1))
+                              std::placeholders::_1)),
+        matchAssocChanged(
+            bus,
+            sdbusplus::bus::match::rules::propertiesChangedNamespace(
+                INVENTORY_PATH, ASSOCIATION_IFACE) +
+                sdbusplus::bus::match::rules::sender(MAPPER_BUSNAME),
+            std::bind(std::mem_fn(&Monitor::assocChanged), this,
+                      std::placeholders::_1)),
+        matchAssocAdded(
+            bus,
+            sdbusplus::bus::match::rules::interfacesAdded() +
+                sdbusplus::bus::match::rules::sender(MAPPER_BUSNAME),
+            std::bind(std::mem_fn(&Monitor::assocAdded), this,
+                      std::placeholders::_1)),
+        matchAssocRemoved(
+            bus,
+            sdbusplus::bus::match::rules::interfacesRemoved() +
+                sdbusplus::bus::match::rules::sender(MAPPER_BUSNAME),
+            std::bind(std::mem_fn(&Monitor::assocRemoved), this,
+                      std::placeholders::_1))
+    {
+        loadAssociations();
+    }
+
+    /** @brief Number of Functional changes that were not applied, since
+     *         they were superseded within the hold time or matched the
+     *         value already applied
+     */
+    inline uint64_t getSuppressed() const
+    {
+        return suppressed;
+    }
 
-    {}
+    /** @brief Logs the counters of the Functional and LED group changes */
+    void logStats() const;
 
   private:
+    /** @brief A Functional value waiting for its hold time to end */
+    struct Unsettled
+    {
+        bool value;
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t suppressed;
+    };
+
     /** @brief sdbusplus D-Bus connection. */
     sdbusplus::bus::bus& bus;
 
+    /** AsyncDBusHandler class handles the D-Bus operations */
+    AsyncDBusHandler dBusHandler;
+
+    /** @brief Hold time of the Functional changes */
+    std::chrono::milliseconds holdTime;
+
+    /** @brief Client of the LED group manager */
+    fru::fault::monitor::GroupClient client;
+
+    /** @brief Functional values within their hold time, by inventory path */
+    std::unordered_map<std::string, Unsettled> unsettled;
+
+    /** @brief Functional values last applied, by inventory path */
+    std::unordered_map<std::string, bool> functional;
+
+    /** @brief Number of Functional changes not applied */
+    uint64_t suppressed = 0;
+
+    /** @brief Timer ending the earliest hold time */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+
     /** @brief sdbusplus signal matches for Monitor */
     sdbusplus::bus::match_t matchSignal;
 
-    /** DBusHandler class handles the D-Bus operations */
-    DBusHandler dBusHandler;
+    /** @brief sdbusplus signal matches for the mapper association objects */
+    sdbusplus::bus::match_t matchAssocChanged;
+    sdbusplus::bus::match_t matchAssocAdded;
+    sdbusplus::bus::match_t matchAssocRemoved;
+
+    /** @brief LED group D-Bus object paths, by inventory D-Bus object path */
+    std::unordered_map<std::string, std::vector<std::string>> ledGroups;
 
     /**
      * @brief Callback handler that gets invoked when the PropertiesChanged
@@ -72,6 +183,26 @@ class Monitor
      */
     void matchHandler(sdbusplus::message::message& msg);
 
+    /**
+     * @brief Starts or restarts the hold time of a Functional change
+     *
+     * @param[in] inventoryPath - Inventory D-Bus object path
+     * @param[in] value         - The Functional property value
+     */
+    void debounce(const std::string& inventoryPath, bool value);
+
+    /** @brief Applies the Functional values whose hold time has ended */
+    void settle();
+
+    /**
+     * @brief Updates the LED groups of an inventory D-Bus object, unless the
+     *        value is the one applied last
+     *
+     * @param[in] inventoryPath - Inventory D-Bus object path
+     * @param[in] value         - The Functional property value
+     */
+    void apply(const std::string& inventoryPath, bool value);
+
     /**
      * @brief From the Inventory D-Bus object, obtains the associated LED group
      *        D-Bus object, where the association name is "fault_led_group"
@@ -83,6 +214,46 @@ class Monitor
     const std::vector<std::string>
         getLedGroupPaths(const std::string& inventoryPath) const;
 
+    /** @brief Reads the "fault_led_group" associations of all the inventory
+     *         D-Bus objects from the mapper, then reconciles
+     */
+    void loadAssociations();
+
+    /** @brief Asserts the LED groups of all the inventory D-Bus objects
+     *         that are not functional, as one update
+     */
+    void reconcile();
+
+    /** @brief Applies the inventory objects of a GetManagedObjects reply
+     *
+     *  @param[in] reply - The GetManagedObjects reply
+     */
+    void reconcile(sdbusplus::message::message& reply);
+
+    /**
+     * @brief Callback handler for the PropertiesChanged signal of a mapper
+     *        association object, updates its endpoints.
+     *
+     * @param[in] msg - The D-Bus message contents
+     */
+    void assocChanged(sdbusplus::message::message& msg);
+
+    /**
+     * @brief Callback handler for the InterfacesAdded signal of the mapper,
+     *        adds the endpoints of a new association object.
+     *
+     * @param[in] msg - The D-Bus message contents
+     */
+    void assocAdded(sdbusplus::message::message& msg);
+
+    /**
+     * @brief Callback handler for the InterfacesRemoved signal of the mapper,
+     *        forgets a removed association object.
+     *
+     * @param[in] msg - The D-Bus message contents
+     */
+    void assocRemoved(sdbusplus::message::message& msg);
+
     /**
      * @brief Update the Asserted property of the LED Group Manager.
      *
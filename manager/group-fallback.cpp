@@ -0,0 +1,168 @@
+#include "config.h"
+
+#include "group-fallback.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace phosphor
+{
+namespace led
+{
+
+const sdbusplus::vtable::vtable_t GroupFallback::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("Asserted", "b", GroupFallback::getAsserted,
+                                GroupFallback::setAsserted,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::end()};
+
+GroupFallback::GroupFallback(sdbusplus::bus::bus& bus,
+                             GroupManager& groupManager) :
+    bus(bus),
+    groupManager(groupManager), vtableSlot(addFallbackVtable()),
+    enumeratorSlot(addNodeEnumerator())
+{
+    // Nothing here
+}
+
+sd_bus_slot* GroupFallback::addFallbackVtable()
+{
+    sd_bus_slot* slot = nullptr;
+    auto r = sd_bus_add_fallback_vtable(bus.get(), &slot, OBJPATH, GROUP_IFACE,
+                                        vtable, findCallback, this);
+    if (r < 0)
+    {
+        throw sdbusplus::exception::SdBusError(-r,
+                                               "sd_bus_add_fallback_vtable");
+    }
+    return slot;
+}
+
+sd_bus_slot* GroupFallback::addNodeEnumerator()
+{
+    sd_bus_slot* slot = nullptr;
+    auto r = sd_bus_add_node_enumerator(bus.get(), &slot, OBJPATH,
+                                        enumeratorCallback, this);
+    if (r < 0)
+    {
+        throw sdbusplus::exception::SdBusError(-r,
+                                               "sd_bus_add_node_enumerator");
+    }
+    return slot;
+}
+
+int GroupFallback::findCallback(sd_bus* /*bus*/, const char* path,
+                                const char* /*interface*/, void* context,
+                                void** found, sd_bus_error* /*error*/)
+{
+    auto o = static_cast<GroupFallback*>(context);
+    if (o->groupManager.find(path) == GroupManager::npos)
+    {
+        return 0;
+    }
+
+    *found = o;
+    return 1;
+}
+
+int GroupFallback::enumeratorCallback(sd_bus* /*bus*/, const char* /*prefix*/,
+                                      void* context, char*** nodes,
+                                      sd_bus_error* /*error*/)
+{
+    const auto& paths =
+        static_cast<GroupFallback*>(context)->groupManager.getPaths();
+
+    // sd-bus takes ownership of the NULL terminated string vector
+    auto v = static_cast<char**>(calloc(paths.size() + 1, sizeof(char*)));
+    if (v == nullptr)
+    {
+        return -ENOMEM;
+    }
+
+    for (size_t index = 0; index < paths.size(); ++index)
+    {
+        v[index] = strdup(paths[index].c_str());
+        if (v[index] == nullptr)
+        {
+            for (size_t i = 0; i < index; ++i)
+            {
+                free(v[i]);
+            }
+            free(v);
+            return -ENOMEM;
+        }
+    }
+
+    *nodes = v;
+    return 0;
+}
+
+int GroupFallback::getAsserted(sd_bus* /*bus*/, const char* path,
+                               const char* /*interface*/,
+                               const char* /*property*/, sd_bus_message* reply,
+                               void* context, sd_bus_error* /*error*/)
+{
+    auto o = static_cast<GroupFallback*>(context);
+    auto index = o->groupManager.find(path);
+    if (index == GroupManager::npos)
+    {
+        return -ENOENT;
+    }
+
+    try
+    {
+        auto m = sdbusplus::message::message(reply);
+        m.append(o->groupManager.asserted(index));
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        return -e.get_errno();
+    }
+
+    return 1;
+}
+
+int GroupFallback::setAsserted(sd_bus* /*bus*/, const char* path,
+                               const char* /*interface*/,
+                               const char* /*property*/, sd_bus_message* value,
+                               void* context, sd_bus_error* /*error*/)
+{
+    auto o = static_cast<GroupFallback*>(context);
+    if (o->groupManager.find(path) == GroupManager::npos)
+    {
+        return -ENOENT;
+    }
+
+    try
+    {
+        bool v{};
+        auto m = sdbusplus::message::message(value);
+        m.read(v);
+
+        // GroupManager emits PropertiesChanged for the group
+        o->groupManager.transition({{path, v}});
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        return -e.get_errno();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error(
+            "Failed to set the group state, ERROR = {ERROR}, PATH = {PATH}",
+            "ERROR", e, "PATH", path);
+        return -EIO;
+    }
+
+    return 1;
+}
+
+} // namespace led
+} // namespace phosphor
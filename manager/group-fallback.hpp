@@ -0,0 +1,89 @@
+#pragma once
+
+#include "group-manager.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/slot.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace led
+{
+
+/** @class GroupFallback
+ *  @brief Serves every LED group under OBJPATH from a single sd-bus
+ *         fallback vtable and node enumerator.
+ *  @details Instead of one sdbusplus object (and vtable, and InterfacesAdded
+ *           signal) per configured group, the groups are served from the
+ *           sorted path index and asserted bitmap of the GroupManager. The
+ *           externally visible xyz.openbmc_project.Led.Group interface is
+ *           unchanged.
+ */
+class GroupFallback
+{
+  public:
+    GroupFallback() = delete;
+    ~GroupFallback() = default;
+    GroupFallback(const GroupFallback&) = delete;
+    GroupFallback& operator=(const GroupFallback&) = delete;
+    GroupFallback(GroupFallback&&) = delete;
+    GroupFallback& operator=(GroupFallback&&) = delete;
+
+    /** @brief Registers the fallback vtable and node enumerator
+     *
+     * @param[in] bus          - Handle to system dbus
+     * @param[in] groupManager - Reference to GroupManager
+     */
+    GroupFallback(sdbusplus::bus::bus& bus, GroupManager& groupManager);
+
+  private:
+    /** @brief sdbusplus handler */
+    sdbusplus::bus::bus& bus;
+
+    /** @brief Reference to GroupManager object */
+    GroupManager& groupManager;
+
+    /** @brief Slot of the fallback vtable */
+    sdbusplus::slot::slot vtableSlot;
+
+    /** @brief Slot of the node enumerator */
+    sdbusplus::slot::slot enumeratorSlot;
+
+    /** @brief Registers the fallback vtable
+     *
+     *  @return             -  The slot owning the registration
+     */
+    sd_bus_slot* addFallbackVtable();
+
+    /** @brief Registers the node enumerator
+     *
+     *  @return             -  The slot owning the registration
+     */
+    sd_bus_slot* addNodeEnumerator();
+
+    /** @brief The vtable shared by all the groups */
+    static const sdbusplus::vtable::vtable_t vtable[];
+
+    /** @brief sd-bus callbacks */
+    static int findCallback(sd_bus* bus, const char* path,
+                            const char* interface, void* context,
+                            void** found, sd_bus_error* error);
+    static int enumeratorCallback(sd_bus* bus, const char* prefix,
+                                  void* context, char*** nodes,
+                                  sd_bus_error* error);
+    static int getAsserted(sd_bus* bus, const char* path,
+                           const char* interface, const char* property,
+                           sd_bus_message* reply, void* context,
+                           sd_bus_error* error);
+    static int setAsserted(sd_bus* bus, const char* path,
+                           const char* interface, const char* property,
+                           sd_bus_message* value, void* context,
+                           sd_bus_error* error);
+};
+
+} // namespace led
+} // namespace phosphor
@@ -0,0 +1,113 @@
+#include "group-index.hpp"
+
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace phosphor
+{
+namespace led
+{
+
+GroupIndex::GroupIndex(const std::vector<std::string>& names) : names(names)
+{
+    forward.reserve(names.size());
+    reverse.reserve(names.size());
+    for (size_t pos = 0; pos < names.size(); ++pos)
+    {
+        forward.emplace_back(names[pos], pos);
+        reverse.emplace_back(
+            std::string(names[pos].rbegin(), names[pos].rend()), pos);
+    }
+    std::ranges::sort(forward);
+    std::ranges::sort(reverse);
+}
+
+std::pair<GroupIndex::Entries::const_iterator,
+          GroupIndex::Entries::const_iterator>
+    GroupIndex::range(const Entries& entries, std::string_view prefix)
+{
+    auto first = std::ranges::lower_bound(
+        entries, prefix, {}, [](const auto& entry) {
+            return std::string_view(entry.first);
+        });
+    auto last = first;
+    while (last != entries.end() && last->first.starts_with(prefix))
+    {
+        ++last;
+    }
+    return {first, last};
+}
+
+std::vector<size_t> GroupIndex::prefix(std::string_view prefix) const
+{
+    std::vector<size_t> positions{};
+
+    auto [first, last] = range(forward, prefix);
+    std::transform(first, last, std::back_inserter(positions),
+                   [](const auto& entry) { return entry.second; });
+    std::ranges::sort(positions);
+
+    return positions;
+}
+
+std::vector<size_t> GroupIndex::match(const std::string& pattern) const
+{
+    static constexpr auto wildcards = "*?[";
+
+    auto head = pattern.find_first_of(wildcards);
+    if (head == std::string::npos && pattern.find('\\') == std::string::npos)
+    {
+        // No wildcard nor escape, this is a lookup of a single name
+        auto [first, last] = range(forward, pattern);
+        if (first != last && first->first == pattern)
+        {
+            return {first->second};
+        }
+        return {};
+    }
+
+    // Resolve the candidates from the longest literal part of the pattern,
+    // either the prefix from the names or the suffix from the reversed
+    // names. Escaped characters are not considered literal.
+    auto literalHead = std::string_view(pattern).substr(0, head);
+    auto literalTail =
+        std::string_view(pattern).substr(pattern.find_last_of("*?[]") + 1);
+    if (literalHead.find('\\') != std::string_view::npos)
+    {
+        literalHead = {};
+    }
+    if (literalTail.find('\\') != std::string_view::npos)
+    {
+        literalTail = {};
+    }
+
+    std::vector<size_t> positions{};
+    auto collect = [this, &pattern, &positions](auto range) {
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            // Reversed entries are matched against their original name
+            if (fnmatch(pattern.c_str(), names[it->second].c_str(), 0) == 0)
+            {
+                positions.emplace_back(it->second);
+            }
+        }
+    };
+
+    if (literalTail.size() > literalHead.size())
+    {
+        std::string suffix(literalTail.rbegin(), literalTail.rend());
+        collect(range(reverse, suffix));
+    }
+    else
+    {
+        collect(range(forward, literalHead));
+    }
+    std::ranges::sort(positions);
+
+    return positions;
+}
+
+} // namespace led
+} // namespace phosphor
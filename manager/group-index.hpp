@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace phosphor
+{
+namespace led
+{
+
+/** @class GroupIndex
+ *  @brief Sorted indexes over the group names for prefix and glob lookups
+ *  @details The names are kept sorted both as they are and reversed, so
+ *           that a glob is resolved from the range matching its longest
+ *           literal prefix or suffix, instead of scanning every name.
+ *           e.g. "*_fault" is looked up as the reversed prefix "tluaf_".
+ */
+class GroupIndex
+{
+  public:
+    GroupIndex() = default;
+    ~GroupIndex() = default;
+    GroupIndex(const GroupIndex&) = delete;
+    GroupIndex& operator=(const GroupIndex&) = delete;
+    GroupIndex(GroupIndex&&) = default;
+    GroupIndex& operator=(GroupIndex&&) = default;
+
+    /** @brief Builds the indexes
+     *
+     *  @param[in] names - The group names, their position is the value
+     *                     returned by the lookups
+     */
+    explicit GroupIndex(const std::vector<std::string>& names);
+
+    /** @brief Returns the groups whose name starts with the prefix
+     *
+     *  @param[in] prefix - Literal prefix of the group names
+     *
+     *  @return - Positions of the matching names, in ascending order
+     */
+    std::vector<size_t> prefix(std::string_view prefix) const;
+
+    /** @brief Returns the groups whose name matches the glob
+     *
+     *  @param[in] pattern - fnmatch(3) style pattern, '*', '?', '[...]' and
+     *                      '\' escapes
+     *
+     *  @return - Positions of the matching names, in ascending order
+     */
+    std::vector<size_t> match(const std::string& pattern) const;
+
+  private:
+    /** @brief Sorted names, with their positions */
+    using Entries = std::vector<std::pair<std::string, size_t>>;
+
+    /** @brief Names by position */
+    std::vector<std::string> names;
+
+    /** @brief Names sorted in order, with their positions */
+    Entries forward;
+
+    /** @brief Reversed names sorted in order, with their positions */
+    Entries reverse;
+
+    /** @brief Returns the range of entries starting with the prefix
+     *
+     *  @param[in] entries - One of the sorted indexes
+     *  @param[in] prefix  - Literal prefix
+     *
+     *  @return - Iterators to the first and past the last entry
+     */
+    static std::pair<Entries::const_iterator, Entries::const_iterator>
+        range(const Entries& entries, std::string_view prefix);
+};
+
+} // namespace led
+} // namespace phosphor
@@ -0,0 +1,467 @@
+#include "config.h"
+
+#include "group-manager.hpp"
+
+#include "group.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/message.hpp>
+#include <xyz/openbmc_project/Led/Physical/server.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+#include <map>
+#include <ranges>
+#include <set>
+#include <string_view>
+#include <tuple>
+
+namespace phosphor
+{
+namespace led
+{
+
+namespace
+{
+
+/** @brief Returns the sorted D-Bus paths of the groups */
+std::vector<std::string> sortedPaths(const GroupMap& ledMap)
+{
+    std::vector<std::string> paths(std::views::keys(ledMap).begin(),
+                                   std::views::keys(ledMap).end());
+    std::ranges::sort(paths);
+    return paths;
+}
+
+/** @brief Returns the names of the groups, the last element of their path */
+std::vector<std::string> groupNames(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> names{};
+    names.reserve(paths.size());
+    std::ranges::transform(paths, std::back_inserter(names),
+                           [](const auto& path) {
+                               return path.substr(path.rfind('/') + 1);
+                           });
+    return names;
+}
+
+} // namespace
+
+const sdbusplus::vtable::vtable_t GroupManager::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("GetEffectiveState", "", "a(ssyqsao)",
+                              GroupManager::getEffectiveState),
+    sdbusplus::vtable::method("SetAll", "bas", "",
+                              GroupManager::setAllCallback),
+    sdbusplus::vtable::method("ClearAll", "as", "",
+                              GroupManager::clearAllCallback),
+    sdbusplus::vtable::method("SetGroups", "a{ob}", "",
+                              GroupManager::setGroupsCallback),
+    sdbusplus::vtable::method("SetByPattern", "sb", "",
+                              GroupManager::setByPatternCallback),
+    sdbusplus::vtable::method("GetByPattern", "s", "a(ob)",
+                              GroupManager::getByPatternCallback),
+    sdbusplus::vtable::signal("GroupsChanged", "a(ob)"),
+    sdbusplus::vtable::end()};
+
+GroupManager::GroupManager(sdbusplus::bus::bus& bus, Manager& manager,
+                           Serialize& serialize, size_t groupSignalLimit) :
+    bus(bus),
+    manager(manager), serialize(serialize), groupSignalLimit(groupSignalLimit),
+    paths(sortedPaths(manager.ledMap)), groupIndex(groupNames(paths)),
+    assertedBits(paths.size(), false), objects(paths.size(), nullptr),
+    iface(bus, OBJPATH, GROUP_MANAGER_IFACE, vtable, this)
+{
+    restore();
+}
+
+size_t GroupManager::find(std::string_view path) const
+{
+    auto it = std::ranges::lower_bound(paths, path);
+    if (it == paths.end() || *it != path)
+    {
+        return npos;
+    }
+    return std::distance(paths.begin(), it);
+}
+
+void GroupManager::attach(size_t index, Group* group)
+{
+    objects[index] = group;
+}
+
+void GroupManager::restore()
+{
+    GroupStates states{};
+    for (size_t index = 0; index < paths.size(); ++index)
+    {
+        if (serialize.getGroupSavedState(paths[index]))
+        {
+            states.emplace(paths[index], true);
+            assertedBits[index] = true;
+        }
+    }
+
+    if (states.empty())
+    {
+        return;
+    }
+
+    // Nothing has been announced yet, so no signals are needed.
+    ActionSet ledsAssert{};
+    ActionSet ledsDeAssert{};
+    manager.setGroupStates(states, ledsAssert, ledsDeAssert);
+    manager.driveLEDs(ledsAssert, ledsDeAssert);
+}
+
+GroupStates GroupManager::transition(const GroupStates& states)
+{
+    // Only keep the groups that are really changing
+    GroupStates changes{};
+    for (const auto& [path, value] : states)
+    {
+        auto index = find(path);
+        if (index == npos)
+        {
+            lg2::debug("Skipping unknown LED group, PATH = {PATH}", "PATH",
+                       path);
+            continue;
+        }
+
+        if (assertedBits[index] != value)
+        {
+            changes.emplace(path, value);
+        }
+    }
+
+    if (changes.empty())
+    {
+        return changes;
+    }
+
+    // Group management is handled by Manager. All the groups are applied
+    // at once, so the LEDs are driven only once for the final state.
+    ActionSet ledsAssert{};
+    ActionSet ledsDeAssert{};
+    manager.setGroupStates(changes, ledsAssert, ledsDeAssert);
+
+    // Store asserted state
+    serialize.storeGroups(changes);
+
+    // If something does not go right here, then there should be an sdbusplus
+    // exception thrown.
+    manager.driveLEDs(ledsAssert, ledsDeAssert);
+
+    auto skipSignal = changes.size() > groupSignalLimit;
+    for (const auto& [path, value] : changes)
+    {
+        auto index = find(path);
+        assertedBits[index] = value;
+        publish(index, skipSignal);
+    }
+
+    emitGroupsChanged(changes);
+
+    return changes;
+}
+
+GroupStates GroupManager::setAll(bool value,
+                                 const std::vector<std::string>& excluded)
+{
+    std::set<std::string_view> skip(excluded.begin(), excluded.end());
+
+    GroupStates states{};
+    for (size_t index = 0; index < paths.size(); ++index)
+    {
+        const auto& path = paths[index];
+        auto name = std::string_view(path).substr(path.rfind('/') + 1);
+        if (!skip.contains(name) && assertedBits[index] != value)
+        {
+            states.emplace(path, value);
+        }
+    }
+
+    return transition(states);
+}
+
+GroupStates GroupManager::setByPattern(const std::string& pattern, bool value)
+{
+    GroupStates states{};
+    for (auto index : groupIndex.match(pattern))
+    {
+        states.emplace(paths[index], value);
+    }
+
+    return transition(states);
+}
+
+GroupStates GroupManager::getByPattern(const std::string& pattern) const
+{
+    GroupStates states{};
+    for (auto index : groupIndex.match(pattern))
+    {
+        states.emplace(paths[index], assertedBits[index]);
+    }
+
+    return states;
+}
+
+void GroupManager::publish(size_t index, bool skipSignal)
+{
+    if (objects[index] != nullptr)
+    {
+        objects[index]->publish(assertedBits[index], skipSignal);
+        return;
+    }
+
+    if (!skipSignal)
+    {
+        sd_bus_emit_properties_changed(bus.get(), paths[index].c_str(),
+                                       GROUP_IFACE, "Asserted", nullptr);
+    }
+}
+
+void GroupManager::emitGroupsChanged(const GroupStates& changes)
+{
+    std::vector<std::tuple<sdbusplus::message::object_path, bool>> list{};
+    list.reserve(changes.size());
+    for (const auto& [path, value] : changes)
+    {
+        list.emplace_back(path, value);
+    }
+
+    try
+    {
+        auto signal = iface.new_signal("GroupsChanged");
+        signal.append(list);
+        signal.signal_send();
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to emit GroupsChanged signal, ERROR = {ERROR}",
+                   "ERROR", e);
+    }
+}
+
+int GroupManager::getEffectiveState(sd_bus_message* msg, void* context,
+                                    sd_bus_error* /*error*/)
+{
+    namespace server = sdbusplus::xyz::openbmc_project::Led::server;
+
+    auto o = static_cast<GroupManager*>(context);
+
+    try
+    {
+        std::vector<std::tuple<std::string, std::string, uint8_t, uint16_t,
+                               std::string,
+                               std::vector<sdbusplus::message::object_path>>>
+            leds{};
+        for (const auto& state : o->manager.getEffectiveState())
+        {
+            leds.emplace_back(
+                state.name, server::convertForMessage(state.action),
+                state.dutyOn, state.period,
+                server::convertForMessage(state.priority),
+                std::vector<sdbusplus::message::object_path>(
+                    state.groups.begin(), state.groups.end()));
+        }
+
+        auto m = sdbusplus::message::message(msg);
+        auto reply = m.new_method_return();
+        reply.append(leds);
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to reply to GetEffectiveState, ERROR = {ERROR}",
+                   "ERROR", e);
+        return -e.get_errno();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to reply to GetEffectiveState, ERROR = {ERROR}",
+                   "ERROR", e);
+        return -EIO;
+    }
+
+    return 1;
+}
+
+int GroupManager::setAllCallback(sd_bus_message* msg, void* context,
+                                 sd_bus_error* /*error*/)
+{
+    auto o = static_cast<GroupManager*>(context);
+
+    try
+    {
+        auto m = sdbusplus::message::message(msg);
+
+        bool value{};
+        std::vector<std::string> excluded{};
+        m.read(value, excluded);
+
+        o->setAll(value, excluded);
+
+        auto reply = m.new_method_return();
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to set all the groups, ERROR = {ERROR}", "ERROR",
+                   e);
+        return -e.get_errno();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to set all the groups, ERROR = {ERROR}", "ERROR",
+                   e);
+        return -EIO;
+    }
+
+    return 1;
+}
+
+int GroupManager::clearAllCallback(sd_bus_message* msg, void* context,
+                                   sd_bus_error* /*error*/)
+{
+    auto o = static_cast<GroupManager*>(context);
+
+    try
+    {
+        auto m = sdbusplus::message::message(msg);
+
+        std::vector<std::string> excluded{};
+        m.read(excluded);
+
+        o->setAll(false, excluded);
+
+        auto reply = m.new_method_return();
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to clear all the groups, ERROR = {ERROR}", "ERROR",
+                   e);
+        return -e.get_errno();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to clear all the groups, ERROR = {ERROR}", "ERROR",
+                   e);
+        return -EIO;
+    }
+
+    return 1;
+}
+
+int GroupManager::setGroupsCallback(sd_bus_message* msg, void* context,
+                                    sd_bus_error* /*error*/)
+{
+    auto o = static_cast<GroupManager*>(context);
+
+    try
+    {
+        auto m = sdbusplus::message::message(msg);
+
+        std::map<sdbusplus::message::object_path, bool> groups{};
+        m.read(groups);
+
+        GroupStates states{};
+        for (const auto& [path, value] : groups)
+        {
+            states.emplace(path.str, value);
+        }
+        o->transition(states);
+
+        auto reply = m.new_method_return();
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to set the groups, ERROR = {ERROR}", "ERROR", e);
+        return -e.get_errno();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to set the groups, ERROR = {ERROR}", "ERROR", e);
+        return -EIO;
+    }
+
+    return 1;
+}
+
+int GroupManager::setByPatternCallback(sd_bus_message* msg, void* context,
+                                       sd_bus_error* /*error*/)
+{
+    auto o = static_cast<GroupManager*>(context);
+
+    try
+    {
+        auto m = sdbusplus::message::message(msg);
+
+        std::string pattern{};
+        bool value{};
+        m.read(pattern, value);
+
+        o->setByPattern(pattern, value);
+
+        auto reply = m.new_method_return();
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to set the groups by pattern, ERROR = {ERROR}",
+                   "ERROR", e);
+        return -e.get_errno();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to set the groups by pattern, ERROR = {ERROR}",
+                   "ERROR", e);
+        return -EIO;
+    }
+
+    return 1;
+}
+
+int GroupManager::getByPatternCallback(sd_bus_message* msg, void* context,
+                                       sd_bus_error* /*error*/)
+{
+    auto o = static_cast<GroupManager*>(context);
+
+    try
+    {
+        auto m = sdbusplus::message::message(msg);
+
+        std::string pattern{};
+        m.read(pattern);
+
+        std::vector<std::tuple<sdbusplus::message::object_path, bool>> list{};
+        for (const auto& [path, value] : o->getByPattern(pattern))
+        {
+            list.emplace_back(path, value);
+        }
+
+        auto reply = m.new_method_return();
+        reply.append(list);
+        reply.method_return();
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to get the groups by pattern, ERROR = {ERROR}",
+                   "ERROR", e);
+        return -e.get_errno();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to get the groups by pattern, ERROR = {ERROR}",
+                   "ERROR", e);
+        return -EIO;
+    }
+
+    return 1;
+}
+
+} // namespace led
+} // namespace phosphor
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "group-index.hpp"
+#include "manager.hpp"
+#include "serialize.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace phosphor
+{
+namespace led
+{
+
+static constexpr auto GROUP_IFACE = "xyz.openbmc_project.Led.Group";
+static constexpr auto GROUP_MANAGER_IFACE =
+    "xyz.openbmc_project.Led.GroupManager";
+
+class Group;
+
+/** @class GroupManager
+ *  @brief Owns the Asserted state of all the LED groups and applies
+ *         changes to them as transitions.
+ *  @details Each transition is applied on the Manager at once, stored with
+ *           a single write and announced with one GroupsChanged signal on
+ *           the groups root, carrying the list of (path, asserted) changes.
+ *           Per group PropertiesChanged signals are emitted only for
+ *           transitions that change at most groupSignalLimit groups.
+ */
+class GroupManager
+{
+  public:
+    GroupManager() = delete;
+    ~GroupManager() = default;
+    GroupManager(const GroupManager&) = delete;
+    GroupManager& operator=(const GroupManager&) = delete;
+    GroupManager(GroupManager&&) = delete;
+    GroupManager& operator=(GroupManager&&) = delete;
+
+    /** @brief Index value of an unknown group */
+    static constexpr auto npos = std::numeric_limits<size_t>::max();
+
+    /** @brief Constructs the group state and restores the saved groups
+     *
+     * @param[in] bus              - Handle to system dbus
+     * @param[in] manager          - Reference to Manager
+     * @param[in] serialize        - Serialize object
+     * @param[in] groupSignalLimit - Largest transition for which per group
+     *                               PropertiesChanged signals are emitted
+     */
+    GroupManager(sdbusplus::bus::bus& bus, Manager& manager,
+                 Serialize& serialize,
+                 size_t groupSignalLimit = std::numeric_limits<size_t>::max());
+
+    /** @brief Looks up the index of a group path
+     *
+     *  @param[in]  path    -  D-Bus path of the group
+     *
+     *  @return             -  Index of the group, npos if not found
+     */
+    size_t find(std::string_view path) const;
+
+    /** @brief Sorted D-Bus paths of all the groups */
+    inline const std::vector<std::string>& getPaths() const
+    {
+        return paths;
+    }
+
+    /** @brief Asserted state of the group at the given index */
+    inline bool asserted(size_t index) const
+    {
+        return assertedBits[index];
+    }
+
+    /** @brief Attaches the D-Bus object that publishes a group
+     *
+     *  @details Groups without an attached object are published through
+     *           the fallback vtable.
+     *
+     *  @param[in]  index   -  Index of the group
+     *  @param[in]  group   -  The Group object
+     */
+    void attach(size_t index, Group* group);
+
+    /** @brief Applies the requested Asserted values as one transition
+     *
+     *  @param[in]  states  -  Map of group path to Asserted value. Unknown
+     *                         groups and groups already in the requested
+     *                         state are ignored.
+     *
+     *  @return             -  The groups that changed
+     */
+    GroupStates transition(const GroupStates& states);
+
+    /** @brief Sets all the groups to the same Asserted value as one
+     *         transition
+     *
+     *  @param[in]  value     -  The Asserted value
+     *  @param[in]  excluded  -  Names of groups that are not altered, the
+     *                           last element of their path
+     *
+     *  @return               -  The groups that changed
+     */
+    GroupStates setAll(bool value, const std::vector<std::string>& excluded);
+
+    /** @brief Sets the groups whose name matches a pattern as one transition
+     *
+     *  @param[in]  pattern   -  Glob on the group names, e.g. "*_fault" or
+     *                           "dimm0*"
+     *  @param[in]  value     -  The Asserted value
+     *
+     *  @return               -  The groups that changed
+     */
+    GroupStates setByPattern(const std::string& pattern, bool value);
+
+    /** @brief Returns the groups whose name matches a pattern
+     *
+     *  @param[in]  pattern   -  Glob on the group names
+     *
+     *  @return               -  The matching groups and their Asserted value
+     */
+    GroupStates getByPattern(const std::string& pattern) const;
+
+  private:
+    /** @brief sdbusplus handler */
+    sdbusplus::bus::bus& bus;
+
+    /** @brief Reference to Manager object */
+    Manager& manager;
+
+    /** @brief The serialize class for storing and restoring groups of LEDs */
+    Serialize& serialize;
+
+    /** @brief Largest transition for which per group signals are emitted */
+    size_t groupSignalLimit;
+
+    /** @brief Sorted D-Bus paths of all the groups */
+    std::vector<std::string> paths;
+
+    /** @brief Prefix and glob index over the group names */
+    GroupIndex groupIndex;
+
+    /** @brief Asserted state of the groups, indexed as paths */
+    std::vector<bool> assertedBits;
+
+    /** @brief D-Bus objects of the groups, indexed as paths */
+    std::vector<Group*> objects;
+
+    /** @brief The vtable of the groups root interface */
+    static const sdbusplus::vtable::vtable_t vtable[];
+
+    /** @brief The groups root interface */
+    sdbusplus::server::interface::interface iface;
+
+    /** @brief Restores the saved groups as one transition */
+    void restore();
+
+    /** @brief Updates the published Asserted property of a group
+     *
+     *  @param[in]  index       -  Index of the group
+     *  @param[in]  skipSignal  -  Do not emit PropertiesChanged
+     */
+    void publish(size_t index, bool skipSignal);
+
+    /** @brief Emits the GroupsChanged signal
+     *
+     *  @param[in]  changes -  The groups that changed
+     */
+    void emitGroupsChanged(const GroupStates& changes);
+
+    /** @brief sd-bus callback of the GetEffectiveState method
+     *
+     *  @details Replies with, for each asserted physical LED, its name,
+     *           action, duty cycle, period, priority and the asserted groups
+     *           contributing to it.
+     */
+    static int getEffectiveState(sd_bus_message* msg, void* context,
+                                 sd_bus_error* error);
+
+    /** @brief sd-bus callback of the SetAll method */
+    static int setAllCallback(sd_bus_message* msg, void* context,
+                              sd_bus_error* error);
+
+    /** @brief sd-bus callback of the ClearAll method */
+    static int clearAllCallback(sd_bus_message* msg, void* context,
+                                sd_bus_error* error);
+
+    /** @brief sd-bus callback of the SetGroups method
+     *
+     *  @details Applies a map of group path to Asserted value as one
+     *           transition. Unknown groups are ignored.
+     */
+    static int setGroupsCallback(sd_bus_message* msg, void* context,
+                                 sd_bus_error* error);
+
+    /** @brief sd-bus callback of the SetByPattern method */
+    static int setByPatternCallback(sd_bus_message* msg, void* context,
+                                    sd_bus_error* error);
+
+    /** @brief sd-bus callback of the GetByPattern method */
+    static int getByPatternCallback(sd_bus_message* msg, void* context,
+                                    sd_bus_error* error);
+};
+
+} // namespace led
+} // namespace phosphor
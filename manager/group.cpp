@@ -29,26 +29,11 @@ bool Group::asserted(bool value)
             value);
     }
 
-    // Introducing these to enable gtest.
-    ActionSet ledsAssert{};
-    ActionSet ledsDeAssert{};
-
-    // Group management is handled by Manager. The populated leds* sets are not
-    // really used by production code. They are there to enable gtest for
-    // validation.
-    auto result = manager.setGroupState(path, value, ledsAssert, ledsDeAssert);
-
-    // Store asserted state
-    serialize.storeGroups(path, result);
-
-    // If something does not go right here, then there should be an sdbusplus
-    // exception thrown.
-    manager.driveLEDs(ledsAssert, ledsDeAssert);
-
-    // Set the base class's asserted to 'true' since the getter
-    // operation is handled there.
-    return sdbusplus::xyz::openbmc_project::Led::server::Group::asserted(
-        result);
+    // Group management is handled by GroupManager, which publishes the
+    // resulting Asserted value back through publish().
+    groupManager.transition({{path, value}});
+
+    return sdbusplus::xyz::openbmc_project::Led::server::Group::asserted();
 }
 
 } // namespace led
@@ -1,7 +1,6 @@
 #pragma once
 
-#include "manager.hpp"
-#include "serialize.hpp"
+#include "group-manager.hpp"
 
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server/object.hpp>
@@ -35,24 +34,24 @@ class Group : public GroupInherit
 
     /** @brief Constructs LED Group
      *
-     * @param[in] bus       - Handle to system dbus
-     * @param[in] objPath   - The D-Bus path that hosts LED group
-     * @param[in] manager   - Reference to Manager
-     * @param[in] serialize - Serialize object
-     * @param[in] callBack  - Custom callback when LED group is asserted
+     * @param[in] bus          - Handle to system dbus
+     * @param[in] objPath      - The D-Bus path that hosts LED group
+     * @param[in] groupManager - Reference to GroupManager
+     * @param[in] callBack     - Custom callback when LED group is asserted
      */
     Group(sdbusplus::bus::bus& bus, const std::string& objPath,
-          Manager& manager, Serialize& serialize,
+          GroupManager& groupManager,
           std::function<void(Group*, bool)> callBack = nullptr) :
 
         GroupInherit(bus, objPath.c_str(), GroupInherit::action::defer_emit),
-        path(objPath), manager(manager), serialize(serialize),
-        customCallBack(callBack)
+        path(objPath), groupManager(groupManager), customCallBack(callBack)
     {
-        // Initialize Asserted property value
-        if (serialize.getGroupSavedState(objPath))
+        // Initialize Asserted property value from the restored group state
+        auto index = groupManager.find(objPath);
+        if (index != GroupManager::npos)
         {
-            asserted(true);
+            publish(groupManager.asserted(index), true);
+            groupManager.attach(index, this);
         }
 
         // Emit deferred signal.
@@ -66,15 +65,23 @@ class Group : public GroupInherit
      */
     bool asserted(bool value) override;
 
+    /** @brief Updates the Asserted property without running the action
+     *
+     *  @param[in]  value       -  True or False
+     *  @param[in]  skipSignal  -  Do not emit PropertiesChanged
+     */
+    void publish(bool value, bool skipSignal)
+    {
+        sdbusplus::xyz::openbmc_project::Led::server::Group::asserted(
+            value, skipSignal);
+    }
+
   private:
     /** @brief Path of the group instance */
     std::string path;
 
-    /** @brief Reference to Manager object */
-    Manager& manager;
-
-    /** @brief The serialize class for storing and restoring groups of LEDs */
-    Serialize& serialize;
+    /** @brief Reference to GroupManager object */
+    GroupManager& groupManager;
 
     /** @brief Custom callback when LED group is asserted
      */
@@ -4,6 +4,8 @@
 #include <sdbusplus/exception.hpp>
 #include <sdeventplus/event.hpp>
 
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 
@@ -29,13 +31,14 @@ class JsonConfig
      *
      * Looks for the JSON config file.  If it can't find one, then it
      * will watch entity-manager for the IBMCompatibleSystem interface
-     * to show up.
+     * to show up.  The D-Bus lookups complete from the event loop, on
+     * the given bus.
      *
      * @param[in] bus       - The D-Bus object
      * @param[in] event     - sd event handler
      */
     JsonConfig(sdbusplus::bus::bus& bus, sdeventplus::Event& event) :
-        event(event)
+        event(event), dBusHandler(bus)
     {
         match = std::make_unique<sdbusplus::bus::match_t>(
             bus,
@@ -158,50 +161,73 @@ class JsonConfig
         }
         confFile.clear();
 
-        try
+        // Get all objects implementing the compatible interface
+        dBusHandler.getSubTreePaths(
+            "/", confCompatibleInterface,
+            [this](int ec, const std::vector<std::string>& objects) {
+                if (ec < 0)
+                {
+                    lg2::error(
+                        "Failed to call the SubTreePaths method, ERROR = {ERROR}, INTERFACE = {INTERFACE}",
+                        "ERROR", strerror(-ec), "INTERFACE",
+                        confCompatibleInterface);
+                    return;
+                }
+                getCompatibleNames(objects, 0);
+            });
+    }
+
+    /**
+     * @brief Looks for a config file at the Names of the compatible objects,
+     *        one object after the other, and exits the event loop at the
+     *        first one found
+     *
+     * @param[in] objects - The objects implementing the compatible interface
+     * @param[in] index   - The object to look at
+     */
+    void getCompatibleNames(const std::vector<std::string>& objects,
+                            size_t index)
+    {
+        if (!confFile.empty() || index >= objects.size())
         {
-            // Get all objects implementing the compatible interface
-            auto objects =
-                dBusHandler.getSubTreePaths("/", confCompatibleInterface);
-            for (const auto& path : objects)
-            {
-                try
+            return;
+        }
+
+        // Retrieve json config compatible relative path locations
+        const auto& path = objects[index];
+        dBusHandler.getProperty(
+            path, confCompatibleInterface, confCompatibleProperty,
+            [this, objects, index](int ec, const utils::PropertyValue& value) {
+                if (!confFile.empty())
                 {
-                    // Retrieve json config compatible relative path locations
-                    auto value = dBusHandler.getProperty(
-                        path, confCompatibleInterface, confCompatibleProperty);
-
-                    auto confCompatValues =
-                        std::get<std::vector<std::string>>(value);
-
-                    // Look for a config file at each name relative to the base
-                    // path and use the first one found
-                    if (filePathExists(confCompatValues))
-                    {
-                        // Use the first config file found at a listed location
-                        break;
-                    }
-                    confFile.clear();
+                    // Found by the interfacesAdded match in the meantime
+                    return;
                 }
-                catch (const sdbusplus::exception::exception& e)
+
+                const auto* names =
+                    std::get_if<std::vector<std::string>>(&value);
+                if (ec < 0 || names == nullptr)
                 {
                     // Property unavailable on object.
                     lg2::error(
-                        "Failed to get Names property, ERROR = {ERROR}, INTERFACES = {INTERFACES}, PATH = {PATH}",
-                        "ERROR", e, "INTERFACE", confCompatibleInterface,
-                        "PATH", path);
+                        "Failed to get Names property, ERROR = {ERROR}, INTERFACE = {INTERFACE}, PATH = {PATH}",
+                        "ERROR", strerror(ec < 0 ? -ec : EINVAL), "INTERFACE",
+                        confCompatibleInterface, "PATH", objects[index]);
+                }
+                // Look for a config file at each name relative to the base
+                // path and use the first one found
+                else if (filePathExists(*names))
+                {
+                    match.reset();
 
-                    confFile.clear();
+                    // This results in event.loop() exiting in getJsonConfig
+                    event.exit(0);
+                    return;
                 }
-            }
-        }
-        catch (const sdbusplus::exception::exception& e)
-        {
-            lg2::error(
-                "Failed to call the SubTreePaths method, ERROR = {ERROR}, INTERFACE = {INTERFACE}",
-                "ERROR", e, "INTERFACE", confCompatibleInterface);
-        }
-        return;
+
+                confFile.clear();
+                getCompatibleNames(objects, index + 1);
+            });
     }
 
   private:
@@ -221,8 +247,8 @@ class JsonConfig
      */
     std::unique_ptr<sdbusplus::bus::match_t> match;
 
-    /** DBusHandler class handles the D-Bus operations */
-    utils::DBusHandler dBusHandler;
+    /** AsyncDBusHandler class handles the D-Bus operations */
+    utils::AsyncDBusHandler dBusHandler;
 };
 
 /** Blocking call to find the JSON Config from DBus. */
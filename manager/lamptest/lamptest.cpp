@@ -3,6 +3,8 @@
 #include <phosphor-logging/lg2.hpp>
 
 #include <algorithm>
+#include <cstring>
+#include <memory>
 
 namespace phosphor
 {
@@ -63,6 +65,18 @@ void LampTest::stop()
 
     timer.setEnabled(false);
 
+    // The replies still on their way belong to this lamp test
+    ++run;
+    isLampTestRunning = false;
+
+    if (!lampTestLEDsOn)
+    {
+        // Stopped before the LEDs were set On, they are as they were
+        restorePhysicalLedStates();
+        return;
+    }
+    lampTestLEDsOn = false;
+
     // Stop host lamp test
     doHostLampTest(false);
 
@@ -82,7 +96,6 @@ void LampTest::stop()
         manager.drivePhysicalLED(path, Layout::Action::Off, 0, 0);
     }
 
-    isLampTestRunning = false;
     restorePhysicalLedStates();
 }
 
@@ -102,10 +115,29 @@ Layout::Action LampTest::getActionFromString(const std::string& str)
     return action;
 }
 
-void LampTest::storePhysicalLEDsStates()
+void LampTest::storePhysicalLEDsStates(uint64_t id, std::function<void()> done)
 {
     physicalLEDStatesPriorToLampTest.clear();
 
+    // The replies come back asynchronously, done runs after the last one.
+    // The extra count keeps it from running before all the calls are sent.
+    // The states are only stored if the lamp test is still the same one.
+    struct Pending
+    {
+        size_t count;
+        ActionSet states;
+        std::function<void()> done;
+    };
+    auto pending = std::make_shared<Pending>(1, ActionSet{}, std::move(done));
+    auto complete = [this, id, pending]() {
+        if (--pending->count != 0 || id != run)
+        {
+            return;
+        }
+        physicalLEDStatesPriorToLampTest = std::move(pending->states);
+        pending->done();
+    };
+
     for (const auto& path : physicalLEDPaths)
     {
         auto iter = std::find_if(
@@ -131,34 +163,59 @@ void LampTest::storePhysicalLEDsStates()
             continue;
         }
 
-        std::string state{};
-        uint16_t period{};
-        uint8_t dutyOn{};
-        try
-        {
-            auto properties = dBusHandler.getAllProperties(path, PHY_LED_IFACE);
-
-            state = std::get<std::string>(properties["State"]);
-            period = std::get<uint16_t>(properties["Period"]);
-            dutyOn = std::get<uint8_t>(properties["DutyOn"]);
-        }
-        catch (const sdbusplus::exception::exception& e)
-        {
-            lg2::error(
-                "Failed to get All properties, ERROR = {ERROR}, PATH = {PATH}",
-                "ERROR", e, "PATH", path);
-            continue;
-        }
-
-        phosphor::led::Layout::Action action = getActionFromString(state);
-        if (action != phosphor::led::Layout::Action::Off)
-        {
-            phosphor::led::Layout::LedAction ledAction{
-                name, action, dutyOn, period,
-                phosphor::led::Layout::Action::On};
-            physicalLEDStatesPriorToLampTest.emplace(ledAction);
-        }
+        ++pending->count;
+        dBusHandler.getAllProperties(
+            path, PHY_LED_IFACE,
+            [this, id, path, name, pending,
+             complete](int ec, const PropertyMap& properties) {
+                if (id != run)
+                {
+                    // A stale reply of a stopped lamp test
+                    complete();
+                    return;
+                }
+
+                if (ec < 0)
+                {
+                    lg2::error(
+                        "Failed to get All properties, ERROR = {ERROR}, PATH = {PATH}",
+                        "ERROR", strerror(-ec), "PATH", path);
+                    complete();
+                    return;
+                }
+
+                std::string state{};
+                uint16_t period{};
+                uint8_t dutyOn{};
+                try
+                {
+                    state = std::get<std::string>(properties.at("State"));
+                    period = std::get<uint16_t>(properties.at("Period"));
+                    dutyOn = std::get<uint8_t>(properties.at("DutyOn"));
+                }
+                catch (const std::exception& e)
+                {
+                    lg2::error(
+                        "Failed to get All properties, ERROR = {ERROR}, PATH = {PATH}",
+                        "ERROR", e, "PATH", path);
+                    complete();
+                    return;
+                }
+
+                phosphor::led::Layout::Action action =
+                    getActionFromString(state);
+                if (action != phosphor::led::Layout::Action::Off)
+                {
+                    phosphor::led::Layout::LedAction ledAction{
+                        name, action, dutyOn, period,
+                        phosphor::led::Layout::Action::On};
+                    pending->states.emplace(ledAction);
+                }
+                complete();
+            });
     }
+
+    complete();
 }
 
 void LampTest::start()
@@ -170,19 +227,43 @@ void LampTest::start()
         return;
     }
 
-    // Get paths of all the Physical LED objects
-    physicalLEDPaths = dBusHandler.getSubTreePaths(PHY_LED_PATH, PHY_LED_IFACE);
-
-    // Get physical LEDs states before lamp test
-    storePhysicalLEDsStates();
-
     // restart lamp test, it contains initiate or reset the timer.
     timer.restart(std::chrono::seconds(LAMP_TEST_TIMEOUT_IN_SECS));
     isLampTestRunning = true;
+    auto id = ++run;
 
-    // Notify PHYP to start the lamp test
-    doHostLampTest(true);
+    // Get paths of all the Physical LED objects
+    dBusHandler.getSubTreePaths(
+        PHY_LED_PATH, PHY_LED_IFACE,
+        [this, id](int ec, const std::vector<std::string>& paths) {
+            if (id != run)
+            {
+                // Stopped in the meantime
+                return;
+            }
 
+            if (ec < 0)
+            {
+                lg2::error(
+                    "Failed to get the physical LED paths, ERROR = {ERROR}",
+                    "ERROR", strerror(-ec));
+                return;
+            }
+            physicalLEDPaths = paths;
+
+            // Get physical LEDs states before lamp test, then set them On
+            storePhysicalLEDsStates(id, [this]() {
+                setPhysicalLEDsOn();
+                lampTestLEDsOn = true;
+
+                // Notify PHYP to start the lamp test, once the LEDs are On
+                doHostLampTest(true);
+            });
+        });
+}
+
+void LampTest::setPhysicalLEDsOn()
+{
     // Set all the Physical action to On for lamp test
     for (const auto& path : physicalLEDPaths)
     {
@@ -247,19 +328,18 @@ void LampTest::restorePhysicalLedStates()
 
 void LampTest::doHostLampTest(bool value)
 {
-    try
-    {
-        PropertyValue assertedValue{value};
-        dBusHandler.setProperty(HOST_LAMP_TEST_OBJECT,
-                                "xyz.openbmc_project.Led.Group", "Asserted",
-                                assertedValue);
-    }
-    catch (const sdbusplus::exception::exception& e)
-    {
-        lg2::error(
-            "Failed to set Asserted property, ERROR = {ERROR}, PATH = {PATH}",
-            "ERROR", e, "PATH", std::string(HOST_LAMP_TEST_OBJECT));
-    }
+    PropertyValue assertedValue{value};
+    dBusHandler.setProperty(
+        HOST_LAMP_TEST_OBJECT, "xyz.openbmc_project.Led.Group", "Asserted",
+        assertedValue, [](int ec) {
+            if (ec < 0)
+            {
+                lg2::error(
+                    "Failed to set Asserted property, ERROR = {ERROR}, PATH = {PATH}",
+                    "ERROR", strerror(-ec), "PATH",
+                    std::string(HOST_LAMP_TEST_OBJECT));
+            }
+        });
 }
 
 void LampTest::getPhysicalLEDNamesFromJson(const fs::path& path)
@@ -8,6 +8,8 @@
 #include <nlohmann/json.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <cstdint>
+#include <functional>
 #include <queue>
 #include <vector>
 
@@ -74,8 +76,8 @@ class LampTest
     /** @brief Reference to Manager object */
     Manager& manager;
 
-    /** DBusHandler class handles the D-Bus operations */
-    DBusHandler dBusHandler;
+    /** AsyncDBusHandler class handles the D-Bus operations */
+    AsyncDBusHandler dBusHandler;
 
     /** @brief Pointer to Group object */
     Group* groupObj;
@@ -89,6 +91,14 @@ class LampTest
     /** @brief Get state of the lamp test operation */
     bool isLampTestRunning{false};
 
+    /** @brief Whether the LEDs are set On and the host notified */
+    bool lampTestLEDsOn{false};
+
+    /** @brief Changes with each start and stop, the replies to the calls of
+     *         an earlier lamp test are dropped
+     */
+    uint64_t run = 0;
+
     /** @brief Physical LED states prior to lamp test */
     ActionSet physicalLEDStatesPriorToLampTest;
 
@@ -114,8 +124,16 @@ class LampTest
     /** @brief Restore the physical LEDs states after the lamp test finishes */
     void restorePhysicalLedStates();
 
-    /** @brief Store the physical LEDs states before the lamp test start */
-    void storePhysicalLEDsStates();
+    /** @brief Store the physical LEDs states before the lamp test start
+     *
+     *  @param[in]  id    -  The run of the lamp test
+     *  @param[in]  done  -  Invoked once all the states are stored, unless
+     *                       the lamp test stopped meanwhile
+     */
+    void storePhysicalLEDsStates(uint64_t id, std::function<void()> done);
+
+    /** @brief Set all the physical LEDs On, except the skipped ones */
+    void setPhysicalLEDsOn();
 
     /** @brief Returns action enum based on string
      *
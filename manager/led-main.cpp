@@ -1,6 +1,10 @@
 #include "config.h"
 
+#include "group-manager.hpp"
 #include "group.hpp"
+#ifdef USE_FALLBACK_VTABLE
+#include "group-fallback.hpp"
+#endif
 #include "ledlayout.hpp"
 #ifdef LED_USE_JSON
 #include "json-parser.hpp"
@@ -13,12 +17,19 @@
 #ifdef USE_LAMP_TEST
 #include "lamptest/lamptest.hpp"
 #endif
+#ifdef MONITOR_IN_PROCESS
+#include "fru-fault-monitor.hpp"
+#include "operational-status-monitor.hpp"
+#endif
 
 #include <CLI/CLI.hpp>
 #include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <limits>
 
 int main(int argc, char** argv)
 {
@@ -29,6 +40,83 @@ int main(int argc, char** argv)
     app.add_option("-c,--config", configFile, "Path to JSON config");
 #endif
 
+    size_t groupSignalLimit = std::numeric_limits<size_t>::max();
+    app.add_option("--group-signal-limit", groupSignalLimit,
+                   "Largest number of groups changed at once for which "
+                   "PropertiesChanged is emitted per group");
+
+    unsigned int ledTimeout = 5000;
+    app.add_option("--led-timeout", ledTimeout,
+                   "Milliseconds each call to a physical LED service may "
+                   "take");
+
+    unsigned int breakerThreshold = 3;
+    app.add_option("--breaker-threshold", breakerThreshold,
+                   "Consecutive timeouts after which the writes to a "
+                   "physical LED service fail fast");
+
+    unsigned int breakerOpenTime = 30000;
+    app.add_option("--breaker-open-time", breakerOpenTime,
+                   "Milliseconds before a failing physical LED service is "
+                   "probed again");
+
+    unsigned int ledRetries = 8;
+    app.add_option("--led-retries", ledRetries,
+                   "Retries of a failed physical LED write, with an "
+                   "exponential backoff");
+
+    std::string driftPolicy = "report";
+    app.add_option("--drift-policy", driftPolicy,
+                   "What is done when a physical LED is changed by another "
+                   "agent: ignore, report or correct")
+        ->check(CLI::IsMember({"ignore", "report", "correct"}));
+
+    unsigned int driftWindow = 1000;
+    app.add_option("--drift-window", driftWindow,
+                   "Milliseconds within which a drifted physical LED is "
+                   "corrected");
+
+    std::string sysfsConfig = SYSFS_LEDS_JSON;
+    app.add_option("--sysfs-config", sysfsConfig,
+                   "Path to the JSON config of the LEDs written through "
+                   "sysfs");
+
+    std::vector<std::string> softBlinkLeds;
+    app.add_option("--soft-blink", softBlinkLeds,
+                   "Physical LEDs blinked by the manager, for the sysfs LEDs "
+                   "that can only be turned on and off");
+
+    unsigned int blinkTick = 50;
+    app.add_option("--blink-tick", blinkTick,
+                   "Milliseconds between the toggles of the LEDs blinked by "
+                   "the manager")
+        ->check(CLI::PositiveNumber);
+
+#ifdef MONITOR_IN_PROCESS
+    bool callouts = false;
+    app.add_flag("--callouts", callouts,
+                 "Assert the fault LEDs of the FRUs called out by error logs");
+
+    bool operationalStatus = false;
+    app.add_flag("--operational-status", operationalStatus,
+                 "Assert the fault LEDs of the FRUs that are not functional");
+
+    unsigned int batchWindow = 100;
+    app.add_option("--batch-window", batchWindow,
+                   "Milliseconds over which fault LED changes are collected "
+                   "and applied as one transition");
+
+    unsigned int holdTime = 1000;
+    app.add_option("--functional-hold-time", holdTime,
+                   "Milliseconds the Functional property has to stay "
+                   "unchanged before its LEDs are updated");
+#endif
+
+    unsigned int statsInterval = 3600;
+    app.add_option("--stats-interval", statsInterval,
+                   "Seconds between the logs of the counters, 0 disables "
+                   "them");
+
     CLI11_PARSE(app, argc, argv);
 
     // Get a default event loop
@@ -41,8 +129,25 @@ int main(int argc, char** argv)
     auto systemLedMap = getSystemLedMap(configFile);
 #endif
 
+    /** @brief Limits of the physical LED writes */
+    phosphor::led::DriverConfig driverConfig;
+    driverConfig.timeout = std::chrono::milliseconds(ledTimeout);
+    driverConfig.failureThreshold = breakerThreshold;
+    driverConfig.openTime = std::chrono::milliseconds(breakerOpenTime);
+    driverConfig.retryLimit = ledRetries;
+    driverConfig.driftPolicy =
+        driftPolicy == "ignore"
+            ? phosphor::led::DriftPolicy::Ignore
+            : (driftPolicy == "correct" ? phosphor::led::DriftPolicy::Correct
+                                        : phosphor::led::DriftPolicy::Report);
+    driverConfig.driftWindow = std::chrono::milliseconds(driftWindow);
+    driverConfig.sysfsLeds = phosphor::led::getSysfsLeds(sysfsConfig);
+    driverConfig.softBlinkLeds.insert(softBlinkLeds.begin(),
+                                      softBlinkLeds.end());
+    driverConfig.blinkTick = std::chrono::milliseconds(blinkTick);
+
     /** @brief Group manager object */
-    phosphor::led::Manager manager(bus, systemLedMap);
+    phosphor::led::Manager manager(bus, systemLedMap, event, driverConfig);
 
     /** @brief sd_bus object manager */
     sdbusplus::server::manager::manager objManager(bus, OBJPATH);
@@ -56,11 +161,6 @@ int main(int argc, char** argv)
 #ifdef USE_LAMP_TEST
     phosphor::led::LampTest lampTest(event, manager);
 
-    groups.emplace_back(std::make_unique<phosphor::led::Group>(
-        bus, LAMP_TEST_OBJECT, manager, serialize,
-        std::bind(std::mem_fn(&phosphor::led::LampTest::requestHandler),
-                  &lampTest, std::placeholders::_1, std::placeholders::_2)));
-
     // Register a lamp test method in the manager class, and call this method
     // when the lamp test is started
     manager.setLampTestCallBack(
@@ -68,12 +168,80 @@ int main(int argc, char** argv)
                   &lampTest, std::placeholders::_1, std::placeholders::_2));
 #endif
 
+    /** @brief Group state, restored from the saved groups */
+    phosphor::led::GroupManager groupManager(bus, manager, serialize,
+                                             groupSignalLimit);
+
+#ifdef USE_LAMP_TEST
+    groups.emplace_back(std::make_unique<phosphor::led::Group>(
+        bus, LAMP_TEST_OBJECT, groupManager,
+        std::bind(std::mem_fn(&phosphor::led::LampTest::requestHandler),
+                  &lampTest, std::placeholders::_1, std::placeholders::_2)));
+#endif
+
+#ifdef USE_FALLBACK_VTABLE
+    /** One fallback vtable serves all the groups */
+    phosphor::led::GroupFallback groupFallback(bus, groupManager);
+#else
     /** Now create so many dbus objects as there are groups */
     std::ranges::transform(systemLedMap, std::back_inserter(groups),
-                           [&bus, &manager, &serialize](auto& grp) {
+                           [&bus, &groupManager](auto& grp) {
                                return std::make_unique<phosphor::led::Group>(
-                                   bus, grp.first, manager, serialize);
+                                   bus, grp.first, groupManager);
                            });
+#endif
+
+#ifdef MONITOR_IN_PROCESS
+    // The monitors drive the groups directly, on the same event loop
+    auto sink = [&groupManager](const phosphor::led::GroupStates& states) {
+        groupManager.transition(states);
+    };
+
+    std::unique_ptr<phosphor::led::fru::fault::monitor::Add> calloutMonitor;
+    if (callouts)
+    {
+        calloutMonitor =
+            std::make_unique<phosphor::led::fru::fault::monitor::Add>(
+                bus, event, std::chrono::milliseconds(batchWindow), sink,
+                groupManager.getPaths());
+    }
+
+    std::unique_ptr<phosphor::led::Operational::status::monitor::Monitor>
+        statusMonitor;
+    if (operationalStatus)
+    {
+        statusMonitor = std::make_unique<
+            phosphor::led::Operational::status::monitor::Monitor>(
+            bus, event, std::chrono::milliseconds(holdTime),
+            std::chrono::milliseconds(batchWindow), sink,
+            groupManager.getPaths());
+    }
+#endif
+
+    // Logs the counters periodically
+    using Timer = sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>;
+    std::unique_ptr<Timer> statsTimer;
+    if (statsInterval != 0)
+    {
+        statsTimer = std::make_unique<Timer>(
+            event,
+            [&](auto&) {
+                manager.logStats();
+#ifdef MONITOR_IN_PROCESS
+                if (calloutMonitor)
+                {
+                    calloutMonitor->logStats();
+                }
+                if (statusMonitor)
+                {
+                    statusMonitor->logStats();
+                }
+#endif
+                phosphor::led::utils::DBusHandler::getServiceCache()
+                    .logStats();
+            },
+            std::chrono::seconds(statsInterval));
+    }
 
     // Attach the bus to sd_event to service user requests
     bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
@@ -2,6 +2,7 @@
 
 #include <xyz/openbmc_project/Led/Physical/server.hpp>
 
+#include <map>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -53,5 +54,8 @@ struct LedAction
 using ActionSet = std::set<Layout::LedAction>;
 using GroupMap = std::unordered_map<std::string, ActionSet>;
 
+// Map of group D-Bus object path to its requested Asserted value
+using GroupStates = std::map<std::string, bool>;
+
 } // namespace led
 } // namespace phosphor
@@ -4,7 +4,6 @@
 
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/exception.hpp>
-#include <xyz/openbmc_project/Led/Physical/server.hpp>
 
 #include <algorithm>
 #include <iostream>
@@ -17,6 +16,26 @@ namespace led
 // Assert -or- De-assert
 bool Manager::setGroupState(const std::string& path, bool assert,
                             ActionSet& ledsAssert, ActionSet& ledsDeAssert)
+{
+    updateAssertedGroups(path, assert);
+    computeTransition(ledsAssert, ledsDeAssert);
+
+    // If we survive, then set the state accordingly.
+    return assert;
+}
+
+// Assert -or- De-assert several groups at once
+void Manager::setGroupStates(const GroupStates& states, ActionSet& ledsAssert,
+                             ActionSet& ledsDeAssert)
+{
+    for (const auto& [path, assert] : states)
+    {
+        updateAssertedGroups(path, assert);
+    }
+    computeTransition(ledsAssert, ledsDeAssert);
+}
+
+void Manager::updateAssertedGroups(const std::string& path, bool assert)
 {
     if (assert)
     {
@@ -29,7 +48,10 @@ bool Manager::setGroupState(const std::string& path, bool assert,
             assertedGroups.erase(&ledMap.at(path));
         }
     }
+}
 
+void Manager::computeTransition(ActionSet& ledsAssert, ActionSet& ledsDeAssert)
+{
     // This will contain the union of what's already in the asserted ActionSet
     ActionSet desiredState{};
     for (const auto& grp : assertedGroups)
@@ -94,9 +116,34 @@ bool Manager::setGroupState(const std::string& path, bool assert,
     // Update the current actual and desired(the virtual actual)
     currentState = std::move(temp);
     combinedState = std::move(desiredState);
+}
 
-    // If we survive, then set the state accordingly.
-    return assert;
+std::vector<LedState> Manager::getEffectiveState() const
+{
+    std::vector<LedState> states{};
+    states.reserve(currentState.size());
+
+    for (const auto& led : currentState)
+    {
+        LedState state{led.name,   led.action,   led.dutyOn,
+                       led.period, led.priority, {}};
+
+        auto iter = ledGroups.find(led.name);
+        if (iter != ledGroups.end())
+        {
+            for (const auto& grp : iter->second)
+            {
+                if (assertedGroups.contains(&grp->second))
+                {
+                    state.groups.emplace_back(grp->first);
+                }
+            }
+        }
+
+        states.emplace_back(std::move(state));
+    }
+
+    return states;
 }
 
 void Manager::setLampTestCallBack(
@@ -147,53 +194,7 @@ void Manager::drivePhysicalLED(const std::string& objPath,
                                Layout::Action action, uint8_t dutyOn,
                                const uint16_t period)
 {
-    try
-    {
-        // If Blink, set its property
-        if (action == Layout::Action::Blink)
-        {
-            PropertyValue dutyOnValue{dutyOn};
-            PropertyValue periodValue{period};
-
-            dBusHandler.setProperty(objPath, PHY_LED_IFACE, "DutyOn",
-                                    dutyOnValue);
-            dBusHandler.setProperty(objPath, PHY_LED_IFACE, "Period",
-                                    periodValue);
-        }
-
-        PropertyValue actionValue{getPhysicalAction(action)};
-        dBusHandler.setProperty(objPath, PHY_LED_IFACE, "State", actionValue);
-    }
-    catch (const std::exception& e)
-    {
-        lg2::error(
-            "Error setting property for physical LED, ERROR = {ERROR}, OBJECT_PATH = {PATH}",
-            "ERROR", e, "PATH", objPath);
-    }
-
-    return;
-}
-
-/** @brief Returns action string based on enum */
-std::string Manager::getPhysicalAction(Layout::Action action)
-{
-    namespace server = sdbusplus::xyz::openbmc_project::Led::server;
-
-    // TODO: openbmc/phosphor-led-manager#5
-    //    Somehow need to use the generated Action enum than giving one
-    //    in ledlayout.
-    if (action == Layout::Action::On)
-    {
-        return server::convertForMessage(server::Physical::Action::On);
-    }
-    else if (action == Layout::Action::Blink)
-    {
-        return server::convertForMessage(server::Physical::Action::Blink);
-    }
-    else
-    {
-        return server::convertForMessage(server::Physical::Action::Off);
-    }
+    driver.drive(objPath, action, dutyOn, period);
 }
 
 } // namespace led
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "ledlayout.hpp"
+#include "physical-driver.hpp"
 #include "utils.hpp"
 
+#include <sdeventplus/event.hpp>
+
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace phosphor
 {
@@ -13,8 +17,18 @@ namespace led
 {
 using namespace phosphor::led::utils;
 
-static constexpr auto PHY_LED_PATH = "/xyz/openbmc_project/led/physical/";
-static constexpr auto PHY_LED_IFACE = "xyz.openbmc_project.Led.Physical";
+/** @brief Effective state of a physical LED and the asserted groups that
+ *         contribute to it
+ */
+struct LedState
+{
+    std::string name;
+    Layout::Action action;
+    uint8_t dutyOn;
+    uint16_t period;
+    Layout::Action priority;
+    std::vector<std::string> groups;
+};
 
 /** @class Manager
  *  @brief Manages group of LEDs and applies action on the elements of group
@@ -75,11 +89,22 @@ class Manager
      *
      *  @param [in] bus       - sdbusplus handler
      *  @param [in] GroupMap - LEDs group layout
+     *  @param [in] event     - The event loop running the driver timers
+     *  @param [in] config    - Limits of the physical LED writes
      */
-    Manager(sdbusplus::bus::bus& bus, const GroupMap& ledLayout) :
-        ledMap(ledLayout), bus(bus)
+    Manager(sdbusplus::bus::bus& bus, const GroupMap& ledLayout,
+            const sdeventplus::Event& event, const DriverConfig& config) :
+        ledMap(ledLayout),
+        bus(bus), driver(bus, event, config)
     {
-        // Nothing here
+        // Build the reverse index of LED name to the groups it is part of
+        for (const auto& grp : ledMap)
+        {
+            for (const auto& led : grp.second)
+            {
+                ledGroups[led.name].emplace_back(&grp);
+            }
+        }
     }
 
     /** @brief Given a group name, applies the action on the group
@@ -95,6 +120,17 @@ class Manager
     bool setGroupState(const std::string& path, bool assert,
                        ActionSet& ledsAssert, ActionSet& ledsDeAssert);
 
+    /** @brief Applies the actions on several groups as one transition
+     *
+     *  @param[in]  states        -  Map of dbus path of group to the
+     *                               Asserted value, true or false
+     *  @param[in]  ledsAssert    -  LEDs that are to be asserted new
+     *                               or to a different state
+     *  @param[in]  ledsDeAssert  -  LEDs that are to be Deasserted
+     */
+    void setGroupStates(const GroupStates& states, ActionSet& ledsAssert,
+                        ActionSet& ledsDeAssert);
+
     /** @brief Finds the set of LEDs to operate on and executes action
      *
      *  @param[in]  ledsAssert    -  LEDs that are to be asserted newly
@@ -105,6 +141,13 @@ class Manager
      */
     void driveLEDs(ActionSet& ledsAssert, ActionSet& ledsDeAssert);
 
+    /** @brief Returns the effective state of all the asserted LEDs
+     *
+     *  @return  -  The winning action of each LED along with the asserted
+     *              groups it is part of
+     */
+    std::vector<LedState> getEffectiveState() const;
+
     /** @brief Chooses appropriate action to be triggered on physical LED
      *  and calls into function that applies the actual action.
      *
@@ -124,6 +167,12 @@ class Manager
         std::function<bool(ActionSet& ledsAssert, ActionSet& ledsDeAssert)>
             callBack);
 
+    /** @brief Logs the counters of the physical LED writes */
+    inline void logStats() const
+    {
+        driver.logStats();
+    }
+
   private:
     /** @brief sdbusplus handler */
     sdbusplus::bus::bus& bus;
@@ -131,8 +180,13 @@ class Manager
     /** Map of physical LED path to service name */
     std::unordered_map<std::string, std::string> phyLeds{};
 
-    /** DBusHandler class handles the D-Bus operations */
-    DBusHandler dBusHandler;
+    /** @brief Writes the physical LEDs, so a slow physical LED service
+     *         does not block the event loop */
+    PhysicalDriver driver;
+
+    /** @brief Map of LED name to the groups the LED is part of */
+    std::unordered_map<std::string, std::vector<const GroupMap::value_type*>>
+        ledGroups;
 
     /** @brief Pointers to groups that are in asserted state */
     std::set<const ActionSet*> assertedGroups;
@@ -149,13 +203,21 @@ class Manager
     std::function<bool(ActionSet& ledsAssert, ActionSet& ledsDeAssert)>
         lampTestCallBack;
 
-    /** @brief Returns action string based on enum
+    /** @brief Adds or removes the group from the asserted groups
      *
-     *  @param[in]  action - Action enum
+     *  @param[in]  path          -  dbus path of group
+     *  @param[in]  assert        -  Could be true or false
+     */
+    void updateAssertedGroups(const std::string& path, bool assert);
+
+    /** @brief Computes the LED changes from the asserted groups and
+     *         updates the current state accordingly
      *
-     *  @return string equivalent of the passed in enumeration
+     *  @param[in]  ledsAssert    -  LEDs that are to be asserted new
+     *                               or to a different state
+     *  @param[in]  ledsDeAssert  -  LEDs that are to be Deasserted
      */
-    static std::string getPhysicalAction(Layout::Action action);
+    void computeTransition(ActionSet& ledsAssert, ActionSet& ledsDeAssert);
 };
 
 } // namespace led
@@ -0,0 +1,716 @@
+#include "physical-driver.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/exception.hpp>
+#include <xyz/openbmc_project/Led/Physical/server.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace phosphor
+{
+namespace led
+{
+
+/** @brief Namespace of the physical LED objects */
+static constexpr auto PHY_LED_NAMESPACE = "/xyz/openbmc_project/led/physical";
+
+PhysicalDriver::PhysicalDriver(sdbusplus::bus::bus& bus,
+                               const sdeventplus::Event& event,
+                               const DriverConfig& config) :
+    bus(bus),
+    config(config), dBusHandler(bus),
+    timer(event, std::bind(std::mem_fn(&PhysicalDriver::probe), this)),
+    retryTimer(event,
+               std::bind(std::mem_fn(&PhysicalDriver::runRetries), this)),
+    driftTimer(event,
+               std::bind(std::mem_fn(&PhysicalDriver::correctDrifts), this))
+{
+    for (const auto& [name, device] : config.sysfsLeds)
+    {
+        auto objPath = std::string(PHY_LED_PATH) + name;
+        sysfs.emplace(objPath,
+                      std::make_unique<SysfsPhysical>(
+                          bus, objPath, config.sysfsRoot / device));
+    }
+
+    for (const auto& name : config.softBlinkLeds)
+    {
+        // The lamp test reads the LEDs hosted by a service back to restore
+        // them, which would catch a soft blink On or Off
+        if (!config.sysfsLeds.contains(name))
+        {
+            lg2::error(
+                "Soft blink needs a sysfs LED, not blinked, NAME = {NAME}",
+                "NAME", name);
+            continue;
+        }
+        softBlinkPaths.insert(std::string(PHY_LED_PATH) + name);
+    }
+    if (!softBlinkPaths.empty())
+    {
+        softBlink = std::make_unique<SoftBlink>(
+            event, config.blinkTick,
+            std::bind(std::mem_fn(&PhysicalDriver::toggle), this,
+                      std::placeholders::_1));
+    }
+
+    if (config.driftPolicy != DriftPolicy::Ignore)
+    {
+        matchChanged = std::make_unique<sdbusplus::bus::match_t>(
+            bus,
+            sdbusplus::bus::match::rules::propertiesChangedNamespace(
+                PHY_LED_NAMESPACE, PHY_LED_IFACE),
+            std::bind(std::mem_fn(&PhysicalDriver::propertiesChanged), this,
+                      std::placeholders::_1));
+    }
+}
+
+void PhysicalDriver::drive(const std::string& objPath, Layout::Action action,
+                           uint8_t dutyOn, uint16_t period)
+{
+    desired.insert_or_assign(objPath, Desired{action, dutyOn, period});
+
+    // This write supersedes a pending retry or correction
+    retries.erase(objPath);
+    drifted.erase(objPath);
+    send(objPath);
+}
+
+void PhysicalDriver::send(const std::string& objPath)
+{
+    if (blink(objPath))
+    {
+        return;
+    }
+
+    auto led = sysfs.find(objPath);
+    if (led != sysfs.end())
+    {
+        write(*led->second, objPath);
+        return;
+    }
+
+    getService(
+        objPath, [this, objPath](int ec, const std::string& service) {
+            if (ec < 0)
+            {
+                lg2::error(
+                    "Failed to get the physical LED service, ERROR = {ERROR}, OBJECT_PATH = {PATH}",
+                    "ERROR", strerror(-ec), "PATH", objPath);
+                retry(objPath);
+                return;
+            }
+
+            auto& breaker = breakers[service];
+            if (breaker.state != BreakerState::Closed)
+            {
+                // Driven when the service recovers
+                retries.erase(objPath);
+                breaker.queued.insert(objPath);
+                ++failedFast;
+                return;
+            }
+
+            write(service, objPath);
+        });
+}
+
+bool PhysicalDriver::blink(const std::string& objPath)
+{
+    if (!softBlinkPaths.contains(objPath))
+    {
+        return false;
+    }
+
+    auto it = desired.find(objPath);
+    if (it == desired.end() || it->second.action != Layout::Action::Blink)
+    {
+        // Written with its desired state from now on
+        softBlink->stop(objPath);
+        return false;
+    }
+    const auto& state = it->second;
+
+    // The toggles write the levels, nothing is left to retry
+    retries.erase(objPath);
+
+    auto led = sysfs.find(objPath);
+    if (led != sysfs.end())
+    {
+        led->second->publish(state.action, state.dutyOn, state.period);
+    }
+
+    softBlink->start(objPath, state.dutyOn, state.period);
+    return true;
+}
+
+void PhysicalDriver::toggle(const SoftBlink::Toggles& toggles)
+{
+    for (const auto& [objPath, on] : toggles)
+    {
+        auto led = sysfs.find(objPath);
+        if (led != sysfs.end())
+        {
+            auto r = led->second->level(on);
+            if (r < 0)
+            {
+                lg2::error(
+                    "Error writing the sysfs LED, ERROR = {ERROR}, OBJECT_PATH = {PATH}",
+                    "ERROR", strerror(-r), "PATH", objPath);
+            }
+            continue;
+        }
+
+        // The service is cached, so the writes of a tick go out together
+        getService(objPath,
+                   [this, objPath](int ec, const std::string& service) {
+                       // Otherwise the next toggles write the LED
+                       if (ec == 0 &&
+                           breakers[service].state == BreakerState::Closed)
+                       {
+                           write(service, objPath);
+                       }
+                   });
+    }
+}
+
+Layout::Action PhysicalDriver::getWrittenAction(const std::string& objPath,
+                                                const Desired& state) const
+{
+    if (softBlink && softBlink->contains(objPath))
+    {
+        return softBlink->isOn(objPath) ? Layout::Action::On
+                                        : Layout::Action::Off;
+    }
+    return state.action;
+}
+
+void PhysicalDriver::write(SysfsPhysical& led, const std::string& objPath)
+{
+    auto it = desired.find(objPath);
+    if (it == desired.end())
+    {
+        return;
+    }
+    const auto& state = it->second;
+
+    auto r = led.apply(state.action, state.dutyOn, state.period);
+    if (r < 0)
+    {
+        lg2::error(
+            "Error writing the sysfs LED, ERROR = {ERROR}, OBJECT_PATH = {PATH}",
+            "ERROR", strerror(-r), "PATH", objPath);
+        retry(objPath);
+        return;
+    }
+
+    retries.erase(objPath);
+}
+
+void PhysicalDriver::write(const std::string& service,
+                           const std::string& objPath)
+{
+    auto it = desired.find(objPath);
+    if (it == desired.end())
+    {
+        return;
+    }
+    const auto& state = it->second;
+    auto action = getWrittenAction(objPath, state);
+    track(service, objPath);
+
+    // written() runs once all the Sets replied, with a timeout first, or
+    // the first error, so a failed blink property is retried too
+    struct Replies
+    {
+        unsigned int pending;
+        int ec;
+    };
+    auto replies = std::make_shared<Replies>(
+        action == Layout::Action::Blink ? 3 : 1, 0);
+    auto replied = [this, service, objPath, replies](int ec) {
+        if (ec < 0)
+        {
+            lg2::error(
+                "Error setting property for physical LED, ERROR = {ERROR}, OBJECT_PATH = {PATH}",
+                "ERROR", strerror(-ec), "PATH", objPath);
+            if (replies->ec == 0 || ec == -ETIMEDOUT)
+            {
+                replies->ec = ec;
+            }
+        }
+
+        if (--replies->pending == 0)
+        {
+            written(service, objPath, replies->ec);
+        }
+    };
+
+    // The signals of the write are not drifts
+    ++inFlight[objPath];
+
+    // The service is resolved once for the three calls, and they are queued
+    // in order on the bus, so the blink properties are set before the State
+    if (action == Layout::Action::Blink)
+    {
+        set(service, objPath, "DutyOn", utils::PropertyValue{state.dutyOn},
+            replied);
+        set(service, objPath, "Period", utils::PropertyValue{state.period},
+            replied);
+    }
+
+    set(service, objPath, "State",
+        utils::PropertyValue{getPhysicalAction(action)}, replied);
+}
+
+void PhysicalDriver::getService(
+    const std::string& objPath,
+    std::function<void(int ec, const std::string& service)> callback)
+{
+    dBusHandler.getService(objPath, PHY_LED_IFACE, std::move(callback),
+                           config.timeout);
+}
+
+void PhysicalDriver::set(const std::string& service,
+                         const std::string& objPath,
+                         const std::string& property,
+                         const utils::PropertyValue& value,
+                         std::function<void(int ec)> callback)
+{
+    auto method = bus.new_method_call(service.c_str(), objPath.c_str(),
+                                      utils::DBUS_PROPERTY_IFACE, "Set");
+    method.append(PHY_LED_IFACE, property, value);
+
+    dBusHandler.call(
+        method,
+        [objPath, callback = std::move(callback)](
+            int ec, sdbusplus::message::message& /*reply*/) {
+            if (ec < 0 && ec != -ETIMEDOUT)
+            {
+                // The LED may have moved to another service
+                utils::DBusHandler::getServiceCache().erase(objPath,
+                                                            PHY_LED_IFACE);
+            }
+            callback(ec);
+        },
+        config.timeout);
+}
+
+void PhysicalDriver::written(const std::string& service,
+                             const std::string& objPath, int ec)
+{
+    // The service emits the signals of the write before its reply
+    auto flight = inFlight.find(objPath);
+    if (flight != inFlight.end() && --flight->second == 0)
+    {
+        inFlight.erase(flight);
+    }
+
+    auto& breaker = breakers[service];
+
+    if (ec == -ETIMEDOUT)
+    {
+        if (breaker.state == BreakerState::HalfOpen ||
+            (breaker.state == BreakerState::Closed &&
+             ++breaker.timeouts >= config.failureThreshold))
+        {
+            open(service, breaker);
+        }
+
+        if (breaker.state == BreakerState::Closed)
+        {
+            retry(objPath);
+        }
+        else
+        {
+            // Driven when the service recovers
+            retries.erase(objPath);
+            breaker.queued.insert(objPath);
+        }
+        return;
+    }
+
+    if (ec < 0)
+    {
+        retry(objPath);
+    }
+    else
+    {
+        retries.erase(objPath);
+    }
+
+    // Any reply shows the service is responsive
+    breaker.timeouts = 0;
+    if (breaker.state != BreakerState::HalfOpen)
+    {
+        return;
+    }
+
+    lg2::info("Physical LED service recovered, driving {COUNT} LEDs, "
+              "SERVICE = {SERVICE}",
+              "COUNT", breaker.queued.size(), "SERVICE", service);
+
+    breaker.state = BreakerState::Closed;
+    auto queued = std::move(breaker.queued);
+    breaker.queued.clear();
+    for (const auto& path : queued)
+    {
+        write(service, path);
+    }
+}
+
+void PhysicalDriver::open(const std::string& service, Breaker& breaker)
+{
+    lg2::error("Physical LED service is not responding, failing its writes "
+               "for {TIME} ms, SERVICE = {SERVICE}",
+               "TIME", config.openTime.count(), "SERVICE", service);
+
+    breaker.state = BreakerState::Open;
+    breaker.retryAt = std::chrono::steady_clock::now() + config.openTime;
+    ++trips;
+    schedule();
+}
+
+void PhysicalDriver::probe()
+{
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto& [service, breaker] : breakers)
+    {
+        if (breaker.state != BreakerState::Open || breaker.retryAt > now)
+        {
+            continue;
+        }
+
+        if (breaker.queued.empty())
+        {
+            // Nothing to probe with, the next timeout opens it again
+            breaker.state = BreakerState::Closed;
+            breaker.timeouts = config.failureThreshold - 1;
+            continue;
+        }
+
+        // One LED is driven, the others wait for its result
+        breaker.state = BreakerState::HalfOpen;
+        auto path = breaker.queued.extract(breaker.queued.begin()).value();
+        write(service, path);
+    }
+
+    schedule();
+}
+
+void PhysicalDriver::schedule()
+{
+    std::optional<std::chrono::steady_clock::time_point> next;
+    for (const auto& [service, breaker] : breakers)
+    {
+        if (breaker.state == BreakerState::Open &&
+            (!next || breaker.retryAt < *next))
+        {
+            next = breaker.retryAt;
+        }
+    }
+
+    if (next)
+    {
+        auto now = std::chrono::steady_clock::now();
+        timer.restartOnce(std::max(
+            std::chrono::milliseconds(0),
+            std::chrono::ceil<std::chrono::milliseconds>(*next - now)));
+    }
+}
+
+void PhysicalDriver::retry(const std::string& objPath)
+{
+    auto [it, inserted] = retries.try_emplace(objPath, Retry{0, {}});
+    auto& pending = it->second;
+
+    if (pending.attempts >= config.retryLimit)
+    {
+        lg2::error("Abandoned the physical LED write after {COUNT} retries, "
+                   "OBJECT_PATH = {PATH}",
+                   "COUNT", pending.attempts, "PATH", objPath);
+        retries.erase(it);
+        ++abandoned;
+        return;
+    }
+
+    // 1, 2, 4... times the retry delay
+    auto delay = config.retryDelay * (1ULL << std::min(pending.attempts, 16U));
+    pending.dueAt = std::chrono::steady_clock::now() +
+                    std::min<std::chrono::milliseconds>(delay,
+                                                        config.retryMaxDelay);
+    ++pending.attempts;
+
+    scheduleRetries();
+}
+
+void PhysicalDriver::runRetries()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::string> due;
+
+    for (auto& [path, pending] : retries)
+    {
+        if (pending.dueAt <= now)
+        {
+            // In flight, rescheduled if it fails again
+            pending.dueAt = std::chrono::steady_clock::time_point::max();
+            due.emplace_back(path);
+        }
+    }
+
+    if (!due.empty())
+    {
+        lg2::info("Retrying {COUNT} physical LED writes, OUTSTANDING = "
+                  "{OUTSTANDING}, ABANDONED = {ABANDONED}",
+                  "COUNT", due.size(), "OUTSTANDING", retries.size(),
+                  "ABANDONED", abandoned);
+    }
+
+    // The retries stay pending until their write succeeds
+    for (const auto& path : due)
+    {
+        send(path);
+    }
+
+    scheduleRetries();
+}
+
+void PhysicalDriver::scheduleRetries()
+{
+    std::optional<std::chrono::steady_clock::time_point> next;
+    for (const auto& [path, pending] : retries)
+    {
+        if (pending.dueAt != std::chrono::steady_clock::time_point::max() &&
+            (!next || pending.dueAt < *next))
+        {
+            next = pending.dueAt;
+        }
+    }
+
+    if (next)
+    {
+        auto now = std::chrono::steady_clock::now();
+        retryTimer.restartOnce(std::max(
+            std::chrono::milliseconds(0),
+            std::chrono::ceil<std::chrono::milliseconds>(*next - now)));
+    }
+}
+
+void PhysicalDriver::propertiesChanged(sdbusplus::message::message& msg)
+{
+    std::string objPath = msg.get_path();
+    if (!desired.contains(objPath))
+    {
+        // Not driven by the manager
+        return;
+    }
+
+    std::string interface;
+    Properties properties;
+    try
+    {
+        msg.read(interface, properties);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse physical LED change, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
+
+    changed(objPath, properties);
+}
+
+void PhysicalDriver::changed(const std::string& objPath,
+                             const Properties& properties)
+{
+    auto it = desired.find(objPath);
+    if (it == desired.end() || inFlight.contains(objPath) ||
+        sysfs.contains(objPath) ||
+        (softBlink && softBlink->contains(objPath)))
+    {
+        // Not driven by the manager, its own write, hosted by the manager or
+        // blinked in software
+        return;
+    }
+    const auto& state = it->second;
+
+    auto differs = [&properties](const std::string& name,
+                                 const utils::PropertyValue& value) {
+        auto property = properties.find(name);
+        return property != properties.end() && property->second != value;
+    };
+
+    bool drift = differs("State", getPhysicalAction(state.action));
+    if (state.action == Layout::Action::Blink)
+    {
+        drift = drift || differs("DutyOn", state.dutyOn) ||
+                differs("Period", state.period);
+    }
+    if (!drift)
+    {
+        return;
+    }
+
+    ++drifts;
+    lg2::warning("Physical LED drifted from its desired state, DESIRED = "
+                 "{DESIRED}, DRIFTS = {DRIFTS}, OBJECT_PATH = {PATH}",
+                 "DESIRED", getPhysicalAction(state.action), "DRIFTS", drifts,
+                 "PATH", objPath);
+
+    if (config.driftPolicy != DriftPolicy::Correct)
+    {
+        return;
+    }
+
+    drifted.insert(objPath);
+    if (!driftTimer.isEnabled())
+    {
+        driftTimer.restartOnce(config.driftWindow);
+    }
+}
+
+void PhysicalDriver::correctDrifts()
+{
+    if (drifted.empty())
+    {
+        return;
+    }
+
+    lg2::info("Correcting {COUNT} drifted physical LEDs", "COUNT",
+              drifted.size());
+
+    auto paths = std::move(drifted);
+    drifted.clear();
+    for (const auto& path : paths)
+    {
+        send(path);
+        ++corrected;
+    }
+}
+
+void PhysicalDriver::track(const std::string& service,
+                           const std::string& objPath)
+{
+    auto [it, inserted] = hosts.try_emplace(objPath, service);
+    if (!inserted)
+    {
+        if (it->second == service)
+        {
+            return;
+        }
+
+        // The LED moved to another service
+        hosted[it->second].erase(objPath);
+        it->second = service;
+    }
+    hosted[service].insert(objPath);
+
+    if (!matchOwners.contains(service))
+    {
+        matchOwners.emplace(
+            service,
+            std::make_unique<sdbusplus::bus::match_t>(
+                bus, sdbusplus::bus::match::rules::nameOwnerChanged(service),
+                std::bind(std::mem_fn(&PhysicalDriver::ownerChanged), this,
+                          std::placeholders::_1)));
+    }
+}
+
+void PhysicalDriver::ownerChanged(sdbusplus::message::message& msg)
+{
+    std::string name;
+    std::string oldOwner;
+    std::string newOwner;
+    try
+    {
+        msg.read(name, oldOwner, newOwner);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        lg2::error("Failed to parse NameOwnerChanged message, ERROR = {ERROR}",
+                   "ERROR", e);
+        return;
+    }
+
+    if (newOwner.empty())
+    {
+        // Written again when it is back
+        return;
+    }
+
+    restarted(name);
+}
+
+void PhysicalDriver::restarted(const std::string& service)
+{
+    // The new process starts afresh, so does its breaker
+    auto& breaker = breakers[service];
+    auto paths = std::move(breaker.queued);
+    breaker = Breaker{};
+
+    auto it = hosted.find(service);
+    if (it != hosted.end())
+    {
+        paths.insert(it->second.begin(), it->second.end());
+    }
+    if (paths.empty())
+    {
+        return;
+    }
+
+    lg2::info("Physical LED service restarted, writing its {COUNT} LEDs, "
+              "SERVICE = {SERVICE}",
+              "COUNT", paths.size(), "SERVICE", service);
+
+    // The writes are all sent before any reply is awaited
+    for (const auto& path : paths)
+    {
+        retries.erase(path);
+        drifted.erase(path);
+        write(service, path);
+        ++redriven;
+    }
+}
+
+void PhysicalDriver::logStats() const
+{
+    lg2::info("Physical LED writes, TRIPS = {TRIPS}, FAILED_FAST = "
+              "{FAILED_FAST}, OUTSTANDING = {OUTSTANDING}, ABANDONED = "
+              "{ABANDONED}, DRIFTS = {DRIFTS}, CORRECTED = {CORRECTED}, "
+              "REDRIVEN = {REDRIVEN}",
+              "TRIPS", trips, "FAILED_FAST", failedFast, "OUTSTANDING",
+              retries.size(), "ABANDONED", abandoned, "DRIFTS", drifts,
+              "CORRECTED", corrected, "REDRIVEN", redriven);
+}
+
+std::string PhysicalDriver::getPhysicalAction(Layout::Action action)
+{
+    namespace server = sdbusplus::xyz::openbmc_project::Led::server;
+
+    // TODO: openbmc/phosphor-led-manager#5
+    //    Somehow need to use the generated Action enum than giving one
+    //    in ledlayout.
+    if (action == Layout::Action::On)
+    {
+        return server::convertForMessage(server::Physical::Action::On);
+    }
+    else if (action == Layout::Action::Blink)
+    {
+        return server::convertForMessage(server::Physical::Action::Blink);
+    }
+    else
+    {
+        return server::convertForMessage(server::Physical::Action::Off);
+    }
+}
+
+} // namespace led
+} // namespace phosphor
@@ -0,0 +1,459 @@
+#pragma once
+
+#include "ledlayout.hpp"
+#include "soft-blink.hpp"
+#include "sysfs-led.hpp"
+#include "utils.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace phosphor
+{
+namespace led
+{
+
+static constexpr auto PHY_LED_PATH = "/xyz/openbmc_project/led/physical/";
+static constexpr auto PHY_LED_IFACE = "xyz.openbmc_project.Led.Physical";
+
+/** @brief What is done when a physical LED drifts from its desired state */
+enum class DriftPolicy
+{
+    /** @brief Not watched */
+    Ignore,
+    /** @brief Logged and counted */
+    Report,
+    /** @brief Logged, counted and driven back to the desired state */
+    Correct,
+};
+
+/** @brief Limits of the physical LED writes */
+struct DriverConfig
+{
+    /** @brief Timeout of each D-Bus call to a physical LED service */
+    std::chrono::milliseconds timeout = std::chrono::seconds(5);
+
+    /** @brief Consecutive timeouts after which a service is failed fast */
+    unsigned int failureThreshold = 3;
+
+    /** @brief Time a failing service is left alone before it is probed */
+    std::chrono::milliseconds openTime = std::chrono::seconds(30);
+
+    /** @brief Delay of the first retry of a failed write, doubled on each
+     *         further failure
+     */
+    std::chrono::milliseconds retryDelay = std::chrono::seconds(1);
+
+    /** @brief Longest delay between two retries */
+    std::chrono::milliseconds retryMaxDelay = std::chrono::seconds(60);
+
+    /** @brief Retries of a write before it is abandoned */
+    unsigned int retryLimit = 8;
+
+    /** @brief What is done when a physical LED drifts */
+    DriftPolicy driftPolicy = DriftPolicy::Report;
+
+    /** @brief Time within which a drift is corrected, the drifts found
+     *         meanwhile are corrected together
+     */
+    std::chrono::milliseconds driftWindow = std::chrono::seconds(1);
+
+    /** @brief LEDs written through sysfs instead of D-Bus, by physical LED
+     *         name, with their LED class device name
+     */
+    std::map<std::string, std::string> sysfsLeds;
+
+    /** @brief Directory of the LED class devices */
+    fs::path sysfsRoot = SYSFS_LEDS_ROOT;
+
+    /** @brief LEDs blinked by the manager, by physical LED name, for the
+     *         LEDs that can only be turned on and off, among sysfsLeds
+     */
+    std::set<std::string> softBlinkLeds;
+
+    /** @brief Interval of the software blink ticks */
+    std::chrono::milliseconds blinkTick = std::chrono::milliseconds(50);
+};
+
+/** @class PhysicalDriver
+ *  @brief Writes the physical LEDs and keeps their desired state
+ *  @details Each service hosting physical LEDs has a circuit breaker. After
+ *           failureThreshold consecutive timeouts the breaker opens and the
+ *           writes to the service fail fast: they are not sent, only the
+ *           LEDs are queued. Once openTime has passed one queued LED is
+ *           driven as a probe. If it succeeds the breaker closes and the
+ *           other queued LEDs are driven to their desired state, otherwise
+ *           the breaker opens again.
+ *
+ *           A write fails if any of its property Sets fails. It is retried
+ *           with an exponential backoff, as long as the breaker of its
+ *           service is closed. The retries are kept per LED and always write
+ *           its latest desired state, a new drive of the LED replaces its
+ *           pending retry.
+ *
+ *           The PropertiesChanged signals of the physical LEDs are checked
+ *           against their desired state, to find the changes made by other
+ *           agents. The LEDs with a write in flight are not checked, the
+ *           signals then come from that write. Depending on the policy a
+ *           drift is reported, which is the default, or also corrected by
+ *           the end of the drift window.
+ *
+ *           The services hosting the driven LEDs are watched with
+ *           NameOwnerChanged matches. When a service gets a new owner, it
+ *           restarted with its LEDs at their defaults, so the LEDs it hosts,
+ *           and only those, are written again in one pipelined batch.
+ *
+ *           The LEDs listed in sysfsLeds skip the physical LED service:
+ *           their LED class device is written directly and the manager
+ *           hosts their physical LED objects. Their failed writes are
+ *           retried like the others. Their state is known locally, so their
+ *           signals, published by the manager itself, are not checked for
+ *           drifts.
+ *
+ *           The LEDs listed in softBlinkLeds are blinked by the manager, on
+ *           the ticks of one timer shared by all of them, and in phase with
+ *           one another. They must be sysfsLeds, the others are not blinked.
+ *           They are written On and Off, their physical LED object hosted
+ *           by the manager still publishes the Blink. The changes of
+ *           these LEDs are not checked for drifts while they blink.
+ */
+class PhysicalDriver
+{
+  public:
+    /** @brief Properties of a physical LED, by name */
+    using Properties = std::unordered_map<std::string, utils::PropertyValue>;
+
+    PhysicalDriver() = delete;
+    virtual ~PhysicalDriver() = default;
+    PhysicalDriver(const PhysicalDriver&) = delete;
+    PhysicalDriver& operator=(const PhysicalDriver&) = delete;
+    PhysicalDriver(PhysicalDriver&&) = delete;
+    PhysicalDriver& operator=(PhysicalDriver&&) = delete;
+
+    /** @brief Constructs the driver
+     *
+     *  @param[in] bus    - sdbusplus handler, attached to the event loop
+     *  @param[in] event  - The event loop running the probe timer
+     *  @param[in] config - Limits of the writes
+     */
+    PhysicalDriver(sdbusplus::bus::bus& bus, const sdeventplus::Event& event,
+                   const DriverConfig& config = {});
+
+    /** @brief Drives a physical LED, without waiting for the service
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     *  @param[in]  action    -  Intended action to be triggered
+     *  @param[in]  dutyOn    -  Duty Cycle ON percentage
+     *  @param[in]  period    -  Time taken for one blink cycle
+     */
+    void drive(const std::string& objPath, Layout::Action action,
+               uint8_t dutyOn, uint16_t period);
+
+    /** @brief Number of times a breaker opened */
+    inline uint64_t getTrips() const
+    {
+        return trips;
+    }
+
+    /** @brief Number of writes not sent since their breaker was open */
+    inline uint64_t getFailedFast() const
+    {
+        return failedFast;
+    }
+
+    /** @brief Number of LEDs waiting for a retry */
+    inline size_t getOutstanding() const
+    {
+        return retries.size();
+    }
+
+    /** @brief Number of writes abandoned after retryLimit retries */
+    inline uint64_t getAbandoned() const
+    {
+        return abandoned;
+    }
+
+    /** @brief Number of drifts from the desired state */
+    inline uint64_t getDrifts() const
+    {
+        return drifts;
+    }
+
+    /** @brief Number of drifts corrected */
+    inline uint64_t getCorrected() const
+    {
+        return corrected;
+    }
+
+    /** @brief Number of LEDs written again after their service restarted */
+    inline uint64_t getRedriven() const
+    {
+        return redriven;
+    }
+
+    /** @brief Logs the counters of the writes */
+    void logStats() const;
+
+  protected:
+    /** @brief Looks up the service hosting a physical LED
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     *  @param[in]  callback  -  Invoked with the result and the service
+     */
+    virtual void getService(
+        const std::string& objPath,
+        std::function<void(int ec, const std::string& service)> callback);
+
+    /** @brief Sets a property of a physical LED
+     *
+     *  @param[in]  service   -  Service hosting the LED
+     *  @param[in]  objPath   -  D-Bus object path
+     *  @param[in]  property  -  Name of the property
+     *  @param[in]  value     -  The value to be set
+     *  @param[in]  callback  -  Invoked with the result of the call
+     */
+    virtual void set(const std::string& service, const std::string& objPath,
+                     const std::string& property,
+                     const utils::PropertyValue& value,
+                     std::function<void(int ec)> callback);
+
+    /** @brief Half opens the breakers whose open time has passed */
+    void probe();
+
+    /** @brief Sends the retries that are due */
+    void runRetries();
+
+    /** @brief Checks the changed properties of a physical LED against its
+     *         desired state
+     *
+     *  @param[in]  objPath     -  D-Bus object path
+     *  @param[in]  properties  -  The changed properties
+     */
+    void changed(const std::string& objPath, const Properties& properties);
+
+    /** @brief Drives the drifted LEDs back to their desired state */
+    void correctDrifts();
+
+    /** @brief Writes again the LEDs hosted by a restarted service
+     *
+     *  @param[in]  service   -  The service, with its new owner
+     */
+    void restarted(const std::string& service);
+
+  private:
+    /** @brief Desired state of a physical LED */
+    struct Desired
+    {
+        Layout::Action action;
+        uint8_t dutyOn;
+        uint16_t period;
+    };
+
+    /** @brief State of a circuit breaker */
+    enum class BreakerState
+    {
+        Closed,
+        Open,
+        HalfOpen,
+    };
+
+    /** @brief Circuit breaker of a physical LED service */
+    struct Breaker
+    {
+        BreakerState state = BreakerState::Closed;
+        unsigned int timeouts = 0;
+        std::chrono::steady_clock::time_point retryAt{};
+        std::set<std::string> queued;
+    };
+
+    /** @brief Pending retry of a physical LED */
+    struct Retry
+    {
+        unsigned int attempts;
+        std::chrono::steady_clock::time_point dueAt;
+    };
+
+    /** @brief sdbusplus handler */
+    sdbusplus::bus::bus& bus;
+
+    /** @brief Limits of the writes */
+    DriverConfig config;
+
+    /** @brief Handles the D-Bus operations */
+    utils::AsyncDBusHandler dBusHandler;
+
+    /** @brief Desired state, by physical LED path */
+    std::unordered_map<std::string, Desired> desired;
+
+    /** @brief Circuit breakers, by service */
+    std::unordered_map<std::string, Breaker> breakers;
+
+    /** @brief Timer probing the earliest open breaker */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+
+    /** @brief Number of times a breaker opened */
+    uint64_t trips = 0;
+
+    /** @brief Number of writes not sent since their breaker was open */
+    uint64_t failedFast = 0;
+
+    /** @brief Pending retries, by physical LED path */
+    std::unordered_map<std::string, Retry> retries;
+
+    /** @brief Timer running the earliest retry */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> retryTimer;
+
+    /** @brief Number of writes abandoned */
+    uint64_t abandoned = 0;
+
+    /** @brief Number of writes in flight, by physical LED path */
+    std::unordered_map<std::string, unsigned int> inFlight;
+
+    /** @brief LEDs drifted within the drift window */
+    std::set<std::string> drifted;
+
+    /** @brief Timer ending the drift window */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> driftTimer;
+
+    /** @brief Number of drifts */
+    uint64_t drifts = 0;
+
+    /** @brief Number of drifts corrected */
+    uint64_t corrected = 0;
+
+    /** @brief sdbusplus signal match for the physical LED changes, unless
+     *         the drifts are ignored
+     */
+    std::unique_ptr<sdbusplus::bus::match_t> matchChanged;
+
+    /** @brief Service of the driven LEDs, by physical LED path */
+    std::unordered_map<std::string, std::string> hosts;
+
+    /** @brief Driven LEDs, by service */
+    std::unordered_map<std::string, std::set<std::string>> hosted;
+
+    /** @brief sdbusplus signal matches for the owner changes, by service */
+    std::unordered_map<std::string, std::unique_ptr<sdbusplus::bus::match_t>>
+        matchOwners;
+
+    /** @brief Number of LEDs written again after their service restarted */
+    uint64_t redriven = 0;
+
+    /** @brief The LEDs written through sysfs, by physical LED path */
+    std::unordered_map<std::string, std::unique_ptr<SysfsPhysical>> sysfs;
+
+    /** @brief The LEDs blinked in software, by physical LED path */
+    std::set<std::string> softBlinkPaths;
+
+    /** @brief Blinks the LEDs in software, if any is listed */
+    std::unique_ptr<SoftBlink> softBlink;
+
+    /** @brief Writes the desired state of a physical LED, unless the
+     *         breaker of its service is open
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     */
+    void send(const std::string& objPath);
+
+    /** @brief Blinks a LED in software, or stops blinking it, depending on
+     *         its desired state
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     *
+     *  @return true if the LED is blinked in software
+     */
+    bool blink(const std::string& objPath);
+
+    /** @brief Writes the levels of the LEDs toggled by a software blink tick
+     *
+     *  @param[in]  toggles   -  The LEDs toggled, with their new level
+     */
+    void toggle(const SoftBlink::Toggles& toggles);
+
+    /** @brief Returns the action written to a physical LED, the current
+     *         level of the LEDs blinked in software
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     *  @param[in]  state     -  Desired state of the LED
+     */
+    Layout::Action getWrittenAction(const std::string& objPath,
+                                    const Desired& state) const;
+
+    /** @brief Writes the desired state of a LED through sysfs
+     *
+     *  @param[in]  led       -  The sysfs LED
+     *  @param[in]  objPath   -  D-Bus object path
+     */
+    void write(SysfsPhysical& led, const std::string& objPath);
+
+    /** @brief Writes the desired state of a physical LED
+     *
+     *  @param[in]  service   -  Service hosting the LED
+     *  @param[in]  objPath   -  D-Bus object path
+     */
+    void write(const std::string& service, const std::string& objPath);
+
+    /** @brief Accounts the result of a write on the breaker of its service
+     *
+     *  @param[in]  service   -  Service hosting the LED
+     *  @param[in]  objPath   -  D-Bus object path
+     *  @param[in]  ec        -  Result of the property Sets, a timeout or
+     *                           else the first error of any of them
+     */
+    void written(const std::string& service, const std::string& objPath,
+                 int ec);
+
+    /** @brief Opens the breaker of a service */
+    void open(const std::string& service, Breaker& breaker);
+
+    /** @brief Arms the timer for the earliest open breaker */
+    void schedule();
+
+    /** @brief Schedules the next retry of a failed write
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     */
+    void retry(const std::string& objPath);
+
+    /** @brief Arms the retry timer for the earliest retry */
+    void scheduleRetries();
+
+    /** @brief Callback function for the physical LED property changes
+     *  @param[in] msg - Data associated with subscribed signal
+     */
+    void propertiesChanged(sdbusplus::message::message& msg);
+
+    /** @brief Records the service hosting a LED, and watches its owner
+     *
+     *  @param[in]  service   -  Service hosting the LED
+     *  @param[in]  objPath   -  D-Bus object path
+     */
+    void track(const std::string& service, const std::string& objPath);
+
+    /** @brief Callback function for the owner changes of a service
+     *  @param[in] msg - Data associated with subscribed signal
+     */
+    void ownerChanged(sdbusplus::message::message& msg);
+
+    /** @brief Returns action string based on enum
+     *
+     *  @param[in]  action - Action enum
+     *
+     *  @return string equivalent of the passed in enumeration
+     */
+    static std::string getPhysicalAction(Layout::Action action);
+};
+
+} // namespace led
+} // namespace phosphor
@@ -26,6 +26,21 @@ bool Serialize::getGroupSavedState(const std::string& objPath) const
 }
 
 void Serialize::storeGroups(const std::string& group, bool asserted)
+{
+    updateGroup(group, asserted);
+    saveGroups();
+}
+
+void Serialize::storeGroups(const GroupStates& groups)
+{
+    for (const auto& [group, asserted] : groups)
+    {
+        updateGroup(group, asserted);
+    }
+    saveGroups();
+}
+
+void Serialize::updateGroup(const std::string& group, bool asserted)
 {
     // If the name of asserted group does not exist in the archive and the
     // Asserted property is true, it is inserted into archive.
@@ -41,7 +56,10 @@ void Serialize::storeGroups(const std::string& group, bool asserted)
     {
         savedGroups.emplace(group);
     }
+}
 
+void Serialize::saveGroups()
+{
     auto dir = path.parent_path();
     if (!fs::exists(dir))
     {
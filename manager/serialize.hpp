@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ledlayout.hpp"
+
 #include <filesystem>
 #include <fstream>
 #include <set>
@@ -33,6 +35,12 @@ class Serialize
      */
     void storeGroups(const std::string& group, bool asserted);
 
+    /** @brief Store the asserted state of several groups with one write
+     *
+     *  @param [in] groups    - map of group name to asserted state
+     */
+    void storeGroups(const GroupStates& groups);
+
     /** @brief Is the group in asserted state stored in SAVED_GROUPS_FILE
      *
      *  @param [in] objPath - The D-Bus path that hosts LED group
@@ -46,6 +54,17 @@ class Serialize
      */
     void restoreGroups();
 
+    /** @brief Update the asserted state of a group in savedGroups
+     *
+     *  @param [in] group     - name of the group
+     *  @param [in] asserted  - asserted state, true or false
+     */
+    void updateGroup(const std::string& group, bool asserted);
+
+    /** @brief write savedGroups to SAVED_GROUPS_FILE
+     */
+    void saveGroups();
+
     /** @brief the set of names of asserted groups */
     SavedGroups savedGroups;
 
@@ -0,0 +1,142 @@
+#include "soft-blink.hpp"
+
+#include <algorithm>
+
+namespace phosphor
+{
+namespace led
+{
+
+SoftBlink::SoftBlink(const sdeventplus::Event& event,
+                     std::chrono::milliseconds tick, Callback callback) :
+    tick(tick),
+    callback(std::move(callback)), wheel(wheelSize),
+    timer(event, std::bind(std::mem_fn(&SoftBlink::advance), this), tick)
+{
+    // Ticks only while LEDs blink
+    timer.setEnabled(false);
+}
+
+void SoftBlink::start(const std::string& objPath, uint8_t dutyOn,
+                      uint16_t period)
+{
+    // Rounded to the nearest tick
+    auto tickTime = std::max<int64_t>(1, tick.count());
+    auto periodTicks =
+        std::max<uint32_t>(1, (period + tickTime / 2) / tickTime);
+    auto onTicks =
+        std::min<uint32_t>(periodTicks, (periodTicks * dutyOn + 50) / 100);
+
+    auto it = blinks.find(objPath);
+    if (it != blinks.end())
+    {
+        if (it->second.periodTicks == periodTicks &&
+            it->second.onTicks == onTicks)
+        {
+            return;
+        }
+        if (it->second.toggles())
+        {
+            --toggling;
+        }
+    }
+
+    // In phase with the other LEDs of the same period
+    auto phase = ticks % periodTicks;
+    bool on = phase < onTicks;
+    Blink blink{periodTicks, onTicks, on,
+                ticks - phase + (on ? onTicks : periodTicks), ++generation};
+    blinks.insert_or_assign(objPath, blink);
+
+    // A duty cycle of 0 or 100% stays off or on, without ticks
+    if (blink.toggles())
+    {
+        schedule(objPath, blink);
+        ++toggling;
+    }
+
+    callback(Toggles{{objPath, on}});
+
+    if (toggling == 0)
+    {
+        timer.setEnabled(false);
+    }
+    else if (!timer.isEnabled())
+    {
+        timer.restart(tick);
+    }
+}
+
+void SoftBlink::stop(const std::string& objPath)
+{
+    auto it = blinks.find(objPath);
+    if (it == blinks.end())
+    {
+        return;
+    }
+    if (it->second.toggles())
+    {
+        --toggling;
+    }
+
+    // Its wheel entries are dropped when visited
+    blinks.erase(it);
+
+    if (toggling == 0)
+    {
+        timer.setEnabled(false);
+    }
+}
+
+bool SoftBlink::isOn(const std::string& objPath) const
+{
+    auto it = blinks.find(objPath);
+    return it != blinks.end() && it->second.on;
+}
+
+void SoftBlink::advance()
+{
+    ++ticks;
+    auto& slot = wheel[ticks % wheelSize];
+    auto due = std::move(slot);
+    slot.clear();
+
+    Toggles toggles;
+    for (auto& entry : due)
+    {
+        auto it = blinks.find(entry.objPath);
+        if (it == blinks.end() || it->second.generation != entry.generation)
+        {
+            continue;
+        }
+
+        auto& blink = it->second;
+        if (blink.nextToggle != ticks)
+        {
+            // Due on a later turn of the wheel
+            slot.emplace_back(std::move(entry));
+            continue;
+        }
+
+        blink.on = !blink.on;
+        blink.nextToggle =
+            ticks + (blink.on ? blink.onTicks
+                              : blink.periodTicks - blink.onTicks);
+        schedule(it->first, blink);
+        toggles.emplace_back(it->first, blink.on);
+    }
+
+    if (!toggles.empty())
+    {
+        callback(toggles);
+    }
+}
+
+void SoftBlink::schedule(const std::string& objPath, const Blink& blink)
+{
+    wheel[blink.nextToggle % wheelSize].emplace_back(
+        Slot{objPath, blink.generation});
+}
+
+} // namespace led
+} // namespace phosphor
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace phosphor
+{
+namespace led
+{
+
+/** @class SoftBlink
+ *  @brief Blinks the LEDs that can only be turned on and off
+ *  @details A single timer ticks for all the blinking LEDs, and only while
+ *           some of them toggle, a duty cycle of 0 or 100% needs no tick.
+ *           The LEDs wait on a timing wheel for the tick of their next
+ *           toggle, so a tick visits the LEDs toggling then and no others.
+ *           The phases are counted from the same tick zero: the LEDs
+ *           blinking with the same period are on together, whenever they
+ *           started. The toggles of a tick are handed over as one batch.
+ */
+class SoftBlink
+{
+  public:
+    /** @brief LED toggles of a tick, as physical LED path and new level */
+    using Toggles = std::vector<std::pair<std::string, bool>>;
+
+    /** @brief Writes the toggles of a tick */
+    using Callback = std::function<void(const Toggles&)>;
+
+    /** @brief Number of slots of the timing wheel */
+    static constexpr size_t wheelSize = 64;
+
+    SoftBlink() = delete;
+    ~SoftBlink() = default;
+    SoftBlink(const SoftBlink&) = delete;
+    SoftBlink& operator=(const SoftBlink&) = delete;
+    SoftBlink(SoftBlink&&) = delete;
+    SoftBlink& operator=(SoftBlink&&) = delete;
+
+    /** @brief Constructs the engine, with no LED blinking
+     *
+     *  @param[in] event    - The event loop running the tick timer
+     *  @param[in] tick     - Interval of the ticks, the blink periods and on
+     *                        times are rounded to it
+     *  @param[in] callback - Invoked with the toggles of each tick
+     */
+    SoftBlink(const sdeventplus::Event& event, std::chrono::milliseconds tick,
+              Callback callback);
+
+    /** @brief Blinks a LED, its level is handed over right away
+     *
+     *  @details A LED already blinking the same way keeps its phase.
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     *  @param[in]  dutyOn    -  Duty Cycle ON percentage
+     *  @param[in]  period    -  Time taken for one blink cycle, in ms
+     */
+    void start(const std::string& objPath, uint8_t dutyOn, uint16_t period);
+
+    /** @brief Stops blinking a LED, its level is left as is
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     */
+    void stop(const std::string& objPath);
+
+    /** @brief Whether a LED is blinking
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     */
+    inline bool contains(const std::string& objPath) const
+    {
+        return blinks.contains(objPath);
+    }
+
+    /** @brief Whether a blinking LED is on at the moment
+     *
+     *  @param[in]  objPath   -  D-Bus object path
+     */
+    bool isOn(const std::string& objPath) const;
+
+    /** @brief Moves on by one tick and toggles the LEDs due */
+    void advance();
+
+    /** @brief Number of ticks run */
+    inline uint64_t getTicks() const
+    {
+        return ticks;
+    }
+
+  private:
+    /** @brief A blinking LED */
+    struct Blink
+    {
+        uint32_t periodTicks;
+        uint32_t onTicks;
+        bool on;
+        uint64_t nextToggle;
+        uint64_t generation;
+
+        /** @brief Whether the LED toggles, unlike a duty cycle of 0 or
+         *         100%
+         */
+        inline bool toggles() const
+        {
+            return onTicks > 0 && onTicks < periodTicks;
+        }
+    };
+
+    /** @brief An LED waiting on the wheel, dropped when its generation is
+     *         stale
+     */
+    struct Slot
+    {
+        std::string objPath;
+        uint64_t generation;
+    };
+
+    /** @brief Interval of the ticks */
+    std::chrono::milliseconds tick;
+
+    /** @brief Writes the toggles of a tick */
+    Callback callback;
+
+    /** @brief The blinking LEDs, by physical LED path */
+    std::unordered_map<std::string, Blink> blinks;
+
+    /** @brief LEDs by tick of their next toggle, modulo the wheel size */
+    std::vector<std::vector<Slot>> wheel;
+
+    /** @brief Ticks run, the phases are counted from the first one */
+    uint64_t ticks = 0;
+
+    /** @brief Tells the wheel entries of a LED restarted apart */
+    uint64_t generation = 0;
+
+    /** @brief Number of blinking LEDs that toggle */
+    size_t toggling = 0;
+
+    /** @brief Timer of the ticks, enabled while LEDs toggle */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+
+    /** @brief Puts a LED on the wheel for its next toggle */
+    void schedule(const std::string& objPath, const Blink& blink);
+};
+
+} // namespace led
+} // namespace phosphor
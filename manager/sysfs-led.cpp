@@ -0,0 +1,229 @@
+#include "sysfs-led.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/exception.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+namespace phosphor
+{
+namespace led
+{
+
+std::map<std::string, std::string> getSysfsLeds(const fs::path& path)
+{
+    std::map<std::string, std::string> leds;
+    if (!fs::exists(path) || fs::is_empty(path))
+    {
+        return leds;
+    }
+
+    try
+    {
+        std::ifstream jsonFile(path);
+        auto json = nlohmann::json::parse(jsonFile);
+
+        // define the default JSON as empty
+        const nlohmann::json empty{};
+        for (const auto& entry : json.value("leds", empty))
+        {
+            auto name = entry.value("Name", "");
+            auto device = entry.value("Device", "");
+            if (name.empty() || device.empty())
+            {
+                lg2::error("Sysfs LED without a name or a device, NAME = "
+                           "{NAME}, DEVICE = {DEVICE}",
+                           "NAME", name, "DEVICE", device);
+                continue;
+            }
+            leds.emplace(name, device);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error(
+            "Failed to parse config file, ERROR = {ERROR}, FILE_PATH = {PATH}",
+            "ERROR", e, "PATH", path);
+        leds.clear();
+    }
+
+    return leds;
+}
+
+SysfsLed::~SysfsLed()
+{
+    if (brightnessFd >= 0)
+    {
+        close(brightnessFd);
+    }
+    if (triggerFd >= 0)
+    {
+        close(triggerFd);
+    }
+}
+
+int SysfsLed::set(Layout::Action action, uint8_t dutyOn, uint16_t period)
+{
+    int r = open("brightness", brightnessFd);
+    if (r == 0)
+    {
+        r = open("trigger", triggerFd);
+    }
+    if (r < 0)
+    {
+        return r;
+    }
+
+    if (action == Layout::Action::Blink)
+    {
+        // Setting the timer trigger creates the delay attributes
+        auto delayOn = static_cast<uint32_t>(period) * dutyOn / 100;
+        r = setTrigger("timer");
+        if (r == 0)
+        {
+            r = write("delay_on", std::to_string(delayOn));
+        }
+        if (r == 0)
+        {
+            r = write("delay_off", std::to_string(period - delayOn));
+        }
+        return r;
+    }
+
+    r = setTrigger("none");
+    if (r < 0)
+    {
+        return r;
+    }
+
+    if (action == Layout::Action::On)
+    {
+        r = readMaxBrightness();
+        return r < 0 ? r : write(brightnessFd, *maxBrightness);
+    }
+
+    return write(brightnessFd, "0");
+}
+
+int SysfsLed::open(const char* attribute, int& fd)
+{
+    if (fd >= 0)
+    {
+        return 0;
+    }
+
+    fd = ::open((device / attribute).c_str(), O_WRONLY | O_CLOEXEC);
+    return fd < 0 ? -errno : 0;
+}
+
+int SysfsLed::write(int fd, const std::string& value)
+{
+    // Each write of an attribute replaces its value, from the start
+    auto line = value + '\n';
+    auto written = pwrite(fd, line.data(), line.size(), 0);
+    if (written < 0)
+    {
+        return -errno;
+    }
+    return written == static_cast<ssize_t>(line.size()) ? 0 : -EIO;
+}
+
+int SysfsLed::setTrigger(const std::string& value)
+{
+    if (trigger == value)
+    {
+        return 0;
+    }
+
+    int r = write(triggerFd, value);
+    trigger = r < 0 ? "" : value;
+    return r;
+}
+
+int SysfsLed::write(const char* attribute, const std::string& value)
+{
+    int fd = -1;
+    int r = open(attribute, fd);
+    if (r < 0)
+    {
+        return r;
+    }
+
+    r = write(fd, value);
+    close(fd);
+    return r;
+}
+
+int SysfsLed::readMaxBrightness()
+{
+    if (maxBrightness)
+    {
+        return 0;
+    }
+
+    std::ifstream file(device / "max_brightness");
+    std::string value;
+    if (!(file >> value))
+    {
+        return -EIO;
+    }
+
+    maxBrightness = value;
+    return 0;
+}
+
+SysfsPhysical::SysfsPhysical(sdbusplus::bus::bus& bus,
+                             const std::string& objPath,
+                             const fs::path& device) :
+    PhysicalInherit(bus, objPath.c_str()),
+    led(device)
+{}
+
+int SysfsPhysical::apply(Layout::Action action, uint8_t dutyOn,
+                         uint16_t period)
+{
+    int r = led.set(action, dutyOn, period);
+    if (r < 0)
+    {
+        return r;
+    }
+
+    publish(action, dutyOn, period);
+    return 0;
+}
+
+void SysfsPhysical::publish(Layout::Action action, uint8_t dutyOn,
+                            uint16_t period)
+{
+    // Published like a physical LED daemon would, blink properties first
+    PhysicalInherit::dutyOn(dutyOn);
+    PhysicalInherit::period(period);
+    PhysicalInherit::state(action);
+}
+
+int SysfsPhysical::level(bool on)
+{
+    return led.set(on ? Layout::Action::On : Layout::Action::Off, 0, 0);
+}
+
+SysfsPhysical::Action SysfsPhysical::state(Action value)
+{
+    int r = led.set(value, dutyOn(), period());
+    if (r < 0)
+    {
+        lg2::error("Failed to set the sysfs LED, ERROR = {ERROR}", "ERROR",
+                   strerror(-r));
+        throw sdbusplus::exception::SdBusError(-r, "Set State");
+    }
+
+    return PhysicalInherit::state(value);
+}
+
+} // namespace led
+} // namespace phosphor
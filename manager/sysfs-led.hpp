@@ -0,0 +1,191 @@
+#pragma once
+
+#include "ledlayout.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/object.hpp>
+#include <xyz/openbmc_project/Led/Physical/server.hpp>
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace phosphor
+{
+namespace led
+{
+
+namespace fs = std::filesystem;
+
+/** @brief Root of the LED class devices */
+static constexpr auto SYSFS_LEDS_ROOT = "/sys/class/leds";
+
+/** @brief Loads the LEDs driven through sysfs
+ *
+ *  @details The config lists the physical LEDs by name with their LED class
+ *           device, e.g.
+ *           {"leds": [{"Name": "front_fan", "Device": "pca955x:front_fan"}]}
+ *
+ *  @param[in] path - Path of the JSON config
+ *
+ *  @return - Map of physical LED name to LED class device name, empty if
+ *            the config does not exist
+ */
+std::map<std::string, std::string> getSysfsLeds(const fs::path& path);
+
+/** @class SysfsLed
+ *  @brief Writes the attributes of a LED class device
+ *  @details The brightness and trigger attributes are kept open, and the
+ *           trigger is only written when it changes, so turning the LED on
+ *           or off takes a single write. The delay_on and delay_off
+ *           attributes only exist while the timer trigger is set, so they
+ *           are opened for each blink.
+ */
+class SysfsLed
+{
+  public:
+    SysfsLed() = delete;
+    ~SysfsLed();
+    SysfsLed(const SysfsLed&) = delete;
+    SysfsLed& operator=(const SysfsLed&) = delete;
+    SysfsLed(SysfsLed&&) = delete;
+    SysfsLed& operator=(SysfsLed&&) = delete;
+
+    /** @brief Constructs the LED
+     *
+     *  @param[in] device - Directory of the LED class device
+     */
+    explicit SysfsLed(const fs::path& device) : device(device) {}
+
+    /** @brief Applies an action
+     *
+     *  @param[in]  action    -  The action
+     *  @param[in]  dutyOn    -  Duty Cycle ON percentage, for Blink
+     *  @param[in]  period    -  Time taken for one blink cycle, in ms
+     *
+     *  @return 0 on success, a negative errno otherwise
+     */
+    int set(Layout::Action action, uint8_t dutyOn, uint16_t period);
+
+  private:
+    /** @brief Directory of the LED class device */
+    fs::path device;
+
+    /** @brief The open brightness attribute */
+    int brightnessFd = -1;
+
+    /** @brief The open trigger attribute */
+    int triggerFd = -1;
+
+    /** @brief Value last written to the trigger attribute, the trigger is
+     *         not written again while it is unchanged
+     */
+    std::string trigger;
+
+    /** @brief Value of the max_brightness attribute, once read */
+    std::optional<std::string> maxBrightness;
+
+    /** @brief Opens an attribute, unless it is open already
+     *
+     *  @return 0 on success, a negative errno otherwise
+     */
+    int open(const char* attribute, int& fd);
+
+    /** @brief Writes an attribute through its open descriptor
+     *
+     *  @return 0 on success, a negative errno otherwise
+     */
+    static int write(int fd, const std::string& value);
+
+    /** @brief Writes the trigger attribute, unless it has the value already
+     *
+     *  @return 0 on success, a negative errno otherwise
+     */
+    int setTrigger(const std::string& value);
+
+    /** @brief Writes an attribute that is not kept open
+     *
+     *  @return 0 on success, a negative errno otherwise
+     */
+    int write(const char* attribute, const std::string& value);
+
+    /** @brief Reads the max_brightness attribute
+     *
+     *  @return 0 on success, a negative errno otherwise
+     */
+    int readMaxBrightness();
+};
+
+namespace
+{
+using PhysicalInherit = sdbusplus::server::object_t<
+    sdbusplus::xyz::openbmc_project::Led::server::Physical>;
+}
+
+/** @class SysfsPhysical
+ *  @brief Physical LED object of a LED driven through sysfs
+ *  @details Publishes the state written to the LED, so the D-Bus readers
+ *           see the same physical LED objects whatever drives the LED. The
+ *           property Sets are applied to the LED too.
+ */
+class SysfsPhysical : public PhysicalInherit
+{
+  public:
+    SysfsPhysical() = delete;
+    ~SysfsPhysical() = default;
+    SysfsPhysical(const SysfsPhysical&) = delete;
+    SysfsPhysical& operator=(const SysfsPhysical&) = delete;
+    SysfsPhysical(SysfsPhysical&&) = delete;
+    SysfsPhysical& operator=(SysfsPhysical&&) = delete;
+
+    /** @brief Constructs the physical LED object
+     *
+     *  @param[in] bus     - Handle to system dbus
+     *  @param[in] objPath - The D-Bus path of the physical LED
+     *  @param[in] device  - Directory of the LED class device
+     */
+    SysfsPhysical(sdbusplus::bus::bus& bus, const std::string& objPath,
+                  const fs::path& device);
+
+    /** @brief Applies and publishes an action
+     *
+     *  @param[in]  action    -  The action
+     *  @param[in]  dutyOn    -  Duty Cycle ON percentage, for Blink
+     *  @param[in]  period    -  Time taken for one blink cycle, in ms
+     *
+     *  @return 0 on success, a negative errno otherwise
+     */
+    int apply(Layout::Action action, uint8_t dutyOn, uint16_t period);
+
+    /** @brief Publishes an action, without applying it
+     *
+     *  @param[in]  action    -  The action
+     *  @param[in]  dutyOn    -  Duty Cycle ON percentage, for Blink
+     *  @param[in]  period    -  Time taken for one blink cycle, in ms
+     */
+    void publish(Layout::Action action, uint8_t dutyOn, uint16_t period);
+
+    /** @brief Turns the LED on or off, keeping the published state, for the
+     *         LEDs blinked in software
+     *
+     *  @param[in]  on        -  The level
+     *
+     *  @return 0 on success, a negative errno otherwise
+     */
+    int level(bool on);
+
+    /** @brief Property SET Override function of State, the blink
+     *         properties are applied with the next Blink
+     */
+    Action state(Action value) override;
+
+    using PhysicalInherit::state;
+
+  private:
+    /** @brief The LED class device */
+    SysfsLed led;
+};
+
+} // namespace led
+} // namespace phosphor
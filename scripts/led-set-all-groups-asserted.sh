@@ -3,7 +3,11 @@
 # This shell script sets all the group D-Bus objects
 # in /xyz/openbmc_project/led/groups/ to true or false.
 # If the group is in excluded list, then, they are not
-# altered
+# altered. The excluded names are extended regular
+# expressions matched anywhere in the group path.
+#
+# All the groups are set by the LED manager as one
+# transition through its SetAll method.
 
 function usage()
 {
@@ -30,38 +34,28 @@ if [ "$action" != "true" ] && [ "$action" != "false" ]; then
     exit 1;
 fi
 
-# Get the excluded groups, where $@ is all the agruments passed
-index=2;
-excluded_groups=""
+# The remaining arguments are the excluded groups
+shift
 
-for arg in "$@"
-do
-   if [ "$arg" == "$action" ]
-   then
-       # Must be true/false
-       continue
-   elif [ $index -eq $# ]
-   then
-       excluded_groups="${excluded_groups}$arg"
-   else
-       excluded_groups="${excluded_groups}$arg|"
-   fi
-   ((index+=1))
-done
+service=xyz.openbmc_project.LED.GroupManager
 
-# Now, set the LED group to what has been requested
-if [ ${#excluded_groups} -eq 0 ]
-then
-    for line in $(busctl tree xyz.openbmc_project.LED.GroupManager | grep -e groups/ | awk -F 'xyz' '{print "/xyz" $2}');
+# SetAll excludes the groups by their exact name, so the excluded
+# patterns are resolved here to the names of the matching groups
+excluded=()
+if [ $# -gt 0 ]; then
+    pattern=$(IFS='|'; echo "$*")
+    groups=$(busctl tree "$service" | grep -e groups/ | \
+        awk -F 'xyz' '{print "/xyz" $2}') || exit 1
+    for line in $(echo "$groups" | grep -E "$pattern");
     do
-        busctl set-property xyz.openbmc_project.LED.GroupManager "$line" xyz.openbmc_project.Led.Group Asserted b "$action";
-    done
-else
-    for line in $(busctl tree xyz.openbmc_project.LED.GroupManager | grep -e groups/ | grep -Ev "$excluded_groups" | awk -F 'xyz' '{print "/xyz" $2}');
-    do
-        busctl set-property xyz.openbmc_project.LED.GroupManager "$line" xyz.openbmc_project.Led.Group Asserted b "$action";
+        excluded+=("${line##*/}")
     done
 fi
 
+# Now, set the LED groups to what has been requested
+busctl call "$service" /xyz/openbmc_project/led/groups \
+    xyz.openbmc_project.Led.GroupManager SetAll bas \
+    "$action" ${#excluded[@]} "${excluded[@]}" || exit 1
+
 # Return Success
 exit 0
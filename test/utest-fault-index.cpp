@@ -0,0 +1,71 @@
+#include "fault-index.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::led::fru::fault::monitor;
+
+static constexpr auto entry1 = "/xyz/openbmc_project/logging/entry/1";
+static constexpr auto entry2 = "/xyz/openbmc_project/logging/entry/2";
+static constexpr auto cpu0 = "/xyz/openbmc_project/inventory/system/cpu0";
+static constexpr auto dimm0 = "/xyz/openbmc_project/inventory/system/dimm0";
+
+TEST(FaultIndexTest, testOpenAndDelete)
+{
+    FaultIndex index;
+
+    auto changes = index.update(entry1, {cpu0, dimm0});
+    ASSERT_EQ((std::vector<std::string>{cpu0, dimm0}), changes.asserted);
+    ASSERT_TRUE(changes.deasserted.empty());
+
+    changes = index.remove(entry1);
+    ASSERT_TRUE(changes.asserted.empty());
+    ASSERT_EQ((std::vector<std::string>{cpu0, dimm0}), changes.deasserted);
+    ASSERT_FALSE(index.isFaulted(cpu0));
+}
+
+TEST(FaultIndexTest, testResolveWithoutDelete)
+{
+    FaultIndex index;
+    index.update(entry1, {cpu0});
+
+    // Marking the entry Resolved clears its associations
+    auto changes = index.update(entry1, {});
+    ASSERT_EQ((std::vector<std::string>{cpu0}), changes.deasserted);
+    ASSERT_FALSE(index.isFaulted(cpu0));
+
+    // Deleting it later changes nothing
+    changes = index.remove(entry1);
+    ASSERT_TRUE(changes.asserted.empty());
+    ASSERT_TRUE(changes.deasserted.empty());
+}
+
+TEST(FaultIndexTest, testCountedFaults)
+{
+    FaultIndex index;
+    index.update(entry1, {cpu0});
+
+    // A second fault of the FRU does not change its LED
+    auto changes = index.update(entry2, {cpu0, dimm0});
+    ASSERT_EQ((std::vector<std::string>{dimm0}), changes.asserted);
+
+    // Nor does resolving only one of them
+    changes = index.update(entry1, {});
+    ASSERT_TRUE(changes.deasserted.empty());
+    ASSERT_TRUE(index.isFaulted(cpu0));
+
+    changes = index.remove(entry2);
+    ASSERT_EQ(2, changes.deasserted.size());
+    ASSERT_FALSE(index.isFaulted(cpu0));
+    ASSERT_FALSE(index.isFaulted(dimm0));
+}
+
+TEST(FaultIndexTest, testChangedCallouts)
+{
+    FaultIndex index;
+    index.update(entry1, {cpu0, dimm0});
+
+    auto changes = index.update(entry1, {dimm0});
+    ASSERT_TRUE(changes.asserted.empty());
+    ASSERT_EQ((std::vector<std::string>{cpu0}), changes.deasserted);
+    ASSERT_TRUE(index.isFaulted(dimm0));
+}
@@ -0,0 +1,46 @@
+#include "group-index.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::led;
+
+static const std::vector<std::string> names = {
+    "bmc_booted",     "cpu0_fault",  "cpu1_fault",         "dimm0_fault",
+    "dimm0_identify", "dimm1_fault", "enclosure_identify", "power_on",
+};
+
+TEST(GroupIndexTest, testPrefix)
+{
+    GroupIndex index(names);
+
+    ASSERT_EQ((std::vector<size_t>{3, 4}), index.prefix("dimm0"));
+    ASSERT_EQ((std::vector<size_t>{3, 4, 5}), index.prefix("dimm"));
+    ASSERT_EQ((std::vector<size_t>{7}), index.prefix("power_on"));
+    ASSERT_EQ(names.size(), index.prefix("").size());
+    ASSERT_TRUE(index.prefix("fan").empty());
+}
+
+TEST(GroupIndexTest, testExactMatch)
+{
+    GroupIndex index(names);
+
+    ASSERT_EQ((std::vector<size_t>{0}), index.match("bmc_booted"));
+    ASSERT_TRUE(index.match("bmc").empty());
+
+    // The escapes are removed, as fnmatch does
+    ASSERT_EQ((std::vector<size_t>{0}), index.match("bmc\\_booted"));
+}
+
+TEST(GroupIndexTest, testGlobMatch)
+{
+    GroupIndex index(names);
+
+    ASSERT_EQ((std::vector<size_t>{1, 2, 3, 5}), index.match("*_fault"));
+    ASSERT_EQ((std::vector<size_t>{3, 4}), index.match("dimm0_*"));
+    ASSERT_EQ((std::vector<size_t>{3, 5}), index.match("dimm?_fault"));
+    ASSERT_EQ((std::vector<size_t>{1, 2}), index.match("cpu[01]_fault"));
+    ASSERT_EQ((std::vector<size_t>{4, 6}), index.match("*_identify"));
+    ASSERT_EQ((std::vector<size_t>{1, 3, 4}), index.match("*0_*"));
+    ASSERT_EQ(names.size(), index.match("*").size());
+    ASSERT_TRUE(index.match("*_warning").empty());
+}
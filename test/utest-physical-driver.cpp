@@ -0,0 +1,293 @@
+#include "physical-driver.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdeventplus/event.hpp>
+
+#include <cerrno>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::led;
+
+static constexpr auto ledA = "/xyz/openbmc_project/led/physical/a";
+static constexpr auto ledB = "/xyz/openbmc_project/led/physical/b";
+static constexpr auto ledC = "/xyz/openbmc_project/led/physical/c";
+static constexpr auto actionOn = "xyz.openbmc_project.Led.Physical.Action.On";
+static constexpr auto actionOff =
+    "xyz.openbmc_project.Led.Physical.Action.Off";
+
+/** @brief A driver whose property Sets are answered by the test */
+class FakeDriver : public PhysicalDriver
+{
+  public:
+    /** @brief A property Set awaiting its reply */
+    struct Call
+    {
+        std::string service;
+        std::string objPath;
+        std::string property;
+        utils::PropertyValue value;
+        std::function<void(int ec)> callback;
+    };
+
+    /** @brief The Sets sent, in order */
+    std::deque<Call> calls;
+
+    FakeDriver(const DriverConfig& config,
+               std::unordered_map<std::string, std::string> services) :
+        PhysicalDriver(bus, sdeventplus::Event::get_default(), config),
+        services(std::move(services))
+    {}
+
+    /** @brief Replies to the oldest Set */
+    void reply(int ec)
+    {
+        ASSERT_FALSE(calls.empty());
+        auto call = std::move(calls.front());
+        calls.pop_front();
+        call.callback(ec);
+    }
+
+    using PhysicalDriver::changed;
+    using PhysicalDriver::correctDrifts;
+    using PhysicalDriver::probe;
+    using PhysicalDriver::restarted;
+    using PhysicalDriver::runRetries;
+
+  protected:
+    void getService(const std::string& objPath,
+                    std::function<void(int ec, const std::string& service)>
+                        callback) override
+    {
+        auto it = services.find(objPath);
+        if (it == services.end())
+        {
+            callback(-ENOENT, {});
+            return;
+        }
+        callback(0, it->second);
+    }
+
+    void set(const std::string& service, const std::string& objPath,
+             const std::string& property, const utils::PropertyValue& value,
+             std::function<void(int ec)> callback) override
+    {
+        calls.emplace_back(
+            Call{service, objPath, property, value, std::move(callback)});
+    }
+
+  private:
+    static inline sdbusplus::bus::bus bus = sdbusplus::bus::new_default();
+
+    /** @brief Service hosting each LED */
+    std::unordered_map<std::string, std::string> services;
+};
+
+static DriverConfig getConfig()
+{
+    DriverConfig config;
+    config.failureThreshold = 2;
+    config.openTime = std::chrono::milliseconds(0);
+    config.retryDelay = std::chrono::milliseconds(0);
+    config.retryLimit = 2;
+    return config;
+}
+
+TEST(PhysicalDriverTest, testBreaker)
+{
+    FakeDriver driver(getConfig(), {{ledA, "svc"}, {ledB, "svc"}});
+
+    driver.drive(ledA, Layout::Action::On, 0, 0);
+    ASSERT_EQ(1, driver.calls.size());
+    driver.reply(-ETIMEDOUT);
+    ASSERT_EQ(1, driver.getOutstanding());
+    ASSERT_EQ(0, driver.getTrips());
+
+    // The second timeout in a row opens the breaker
+    driver.runRetries();
+    ASSERT_EQ(1, driver.calls.size());
+    driver.reply(-ETIMEDOUT);
+    ASSERT_EQ(1, driver.getTrips());
+    ASSERT_EQ(0, driver.getOutstanding());
+
+    // The writes then fail fast
+    driver.drive(ledB, Layout::Action::On, 0, 0);
+    ASSERT_EQ(1, driver.getFailedFast());
+    ASSERT_TRUE(driver.calls.empty());
+
+    // A timed out probe opens it again
+    driver.probe();
+    ASSERT_EQ(1, driver.calls.size());
+    driver.reply(-ETIMEDOUT);
+    ASSERT_EQ(2, driver.getTrips());
+    ASSERT_TRUE(driver.calls.empty());
+
+    // A successful probe closes it and drives the other queued LED
+    driver.probe();
+    ASSERT_EQ(1, driver.calls.size());
+    auto probed = driver.calls.front().objPath;
+    driver.reply(0);
+    ASSERT_EQ(1, driver.calls.size());
+    ASSERT_NE(probed, driver.calls.front().objPath);
+    driver.reply(0);
+    ASSERT_EQ(2, driver.getTrips());
+    ASSERT_EQ(0, driver.getOutstanding());
+}
+
+TEST(PhysicalDriverTest, testErrorsDoNotTrip)
+{
+    auto config = getConfig();
+    config.retryLimit = 8;
+    FakeDriver driver(config, {{ledA, "svc"}});
+
+    driver.drive(ledA, Layout::Action::On, 0, 0);
+    driver.reply(-ETIMEDOUT);
+
+    // Any other reply resets the count of timeouts
+    driver.runRetries();
+    driver.reply(-EIO);
+    driver.runRetries();
+    driver.reply(-ETIMEDOUT);
+    ASSERT_EQ(0, driver.getTrips());
+    ASSERT_EQ(1, driver.getOutstanding());
+}
+
+TEST(PhysicalDriverTest, testRetries)
+{
+    FakeDriver driver(getConfig(), {{ledA, "svc"}});
+
+    driver.drive(ledA, Layout::Action::On, 0, 0);
+    driver.reply(-EIO);
+    ASSERT_EQ(1, driver.getOutstanding());
+
+    driver.runRetries();
+    driver.reply(-EIO);
+    ASSERT_EQ(1, driver.getOutstanding());
+
+    // Abandoned once retryLimit retries failed
+    driver.runRetries();
+    driver.reply(-EIO);
+    ASSERT_EQ(0, driver.getOutstanding());
+    ASSERT_EQ(1, driver.getAbandoned());
+
+    // A failed lookup of the service is retried too
+    driver.drive(ledB, Layout::Action::On, 0, 0);
+    ASSERT_TRUE(driver.calls.empty());
+    ASSERT_EQ(1, driver.getOutstanding());
+
+    // A new drive replaces the pending retry
+    driver.drive(ledA, Layout::Action::Off, 0, 0);
+    driver.reply(0);
+    ASSERT_EQ(1, driver.getOutstanding());
+}
+
+TEST(PhysicalDriverTest, testBlinkPropertyFailed)
+{
+    FakeDriver driver(getConfig(), {{ledA, "svc"}});
+
+    driver.drive(ledA, Layout::Action::Blink, 50, 1000);
+    ASSERT_EQ(3, driver.calls.size());
+    ASSERT_EQ("DutyOn", driver.calls[0].property);
+    ASSERT_EQ("Period", driver.calls[1].property);
+    ASSERT_EQ("State", driver.calls[2].property);
+
+    // Accounted once all the Sets replied
+    driver.reply(0);
+    driver.reply(-EIO);
+    ASSERT_EQ(0, driver.getOutstanding());
+    driver.reply(0);
+    ASSERT_EQ(1, driver.getOutstanding());
+
+    driver.runRetries();
+    ASSERT_EQ(3, driver.calls.size());
+}
+
+TEST(PhysicalDriverTest, testDriftCorrected)
+{
+    auto config = getConfig();
+    config.driftPolicy = DriftPolicy::Correct;
+    FakeDriver driver(config, {{ledA, "svc"}});
+
+    driver.drive(ledA, Layout::Action::On, 0, 0);
+
+    // The signals of its own write are not drifts
+    driver.changed(ledA, {{"State", std::string(actionOff)}});
+    driver.reply(0);
+    ASSERT_EQ(0, driver.getDrifts());
+
+    driver.changed(ledA, {{"State", std::string(actionOn)}});
+    ASSERT_EQ(0, driver.getDrifts());
+
+    driver.changed(ledA, {{"State", std::string(actionOff)}});
+    ASSERT_EQ(1, driver.getDrifts());
+
+    driver.correctDrifts();
+    ASSERT_EQ(1, driver.getCorrected());
+    ASSERT_EQ(1, driver.calls.size());
+    ASSERT_EQ(utils::PropertyValue{std::string(actionOn)},
+              driver.calls.front().value);
+}
+
+TEST(PhysicalDriverTest, testDriftReported)
+{
+    auto config = getConfig();
+    config.driftPolicy = DriftPolicy::Report;
+    FakeDriver driver(config, {{ledA, "svc"}});
+
+    driver.drive(ledA, Layout::Action::On, 0, 0);
+    driver.reply(0);
+
+    driver.changed(ledA, {{"State", std::string(actionOff)}});
+    ASSERT_EQ(1, driver.getDrifts());
+
+    driver.correctDrifts();
+    ASSERT_EQ(0, driver.getCorrected());
+    ASSERT_TRUE(driver.calls.empty());
+}
+
+TEST(PhysicalDriverTest, testRedrive)
+{
+    FakeDriver driver(getConfig(),
+                      {{ledA, "svc1"}, {ledB, "svc1"}, {ledC, "svc2"}});
+
+    driver.drive(ledA, Layout::Action::On, 0, 0);
+    driver.drive(ledB, Layout::Action::Off, 0, 0);
+    driver.drive(ledC, Layout::Action::On, 0, 0);
+    for (int i = 0; i < 3; ++i)
+    {
+        driver.reply(0);
+    }
+
+    // Only the LEDs of the restarted service are written again
+    driver.restarted("svc1");
+    ASSERT_EQ(2, driver.getRedriven());
+    ASSERT_EQ(2, driver.calls.size());
+    for (const auto& call : driver.calls)
+    {
+        ASSERT_EQ("svc1", call.service);
+    }
+}
+
+TEST(PhysicalDriverTest, testRedriveClosesBreaker)
+{
+    FakeDriver driver(getConfig(), {{ledA, "svc"}});
+
+    driver.drive(ledA, Layout::Action::On, 0, 0);
+    driver.reply(-ETIMEDOUT);
+    driver.runRetries();
+    driver.reply(-ETIMEDOUT);
+    ASSERT_EQ(1, driver.getTrips());
+
+    // The new process gets the queued LED right away
+    driver.restarted("svc");
+    ASSERT_EQ(1, driver.calls.size());
+    driver.reply(0);
+    ASSERT_EQ(0, driver.getOutstanding());
+
+    driver.drive(ledA, Layout::Action::Off, 0, 0);
+    ASSERT_EQ(1, driver.calls.size());
+    ASSERT_EQ(0, driver.getFailedFast());
+}
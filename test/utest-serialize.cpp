@@ -42,3 +42,26 @@ TEST(SerializeTest, testStoreGroups)
     newSerial.storeGroups(enclosureIdentify, false);
     ASSERT_EQ(false, newSerial.getGroupSavedState(enclosureIdentify));
 }
+
+TEST(SerializeTest, testStoreGroupsAtOnce)
+{
+    static constexpr auto& path = "config/led-save-group-batch.json";
+    static constexpr auto& bmcBooted =
+        "/xyz/openbmc_project/led/groups/bmc_booted";
+    static constexpr auto& powerOn = "/xyz/openbmc_project/led/groups/power_on";
+
+    Serialize serialize(path);
+
+    serialize.storeGroups({{bmcBooted, true}, {powerOn, true}});
+    ASSERT_EQ(true, serialize.getGroupSavedState(bmcBooted));
+    ASSERT_EQ(true, serialize.getGroupSavedState(powerOn));
+
+    Serialize newSerial(path);
+
+    ASSERT_EQ(true, newSerial.getGroupSavedState(bmcBooted));
+    ASSERT_EQ(true, newSerial.getGroupSavedState(powerOn));
+
+    newSerial.storeGroups({{bmcBooted, false}, {powerOn, false}});
+    ASSERT_EQ(false, newSerial.getGroupSavedState(bmcBooted));
+    ASSERT_EQ(false, newSerial.getGroupSavedState(powerOn));
+}
@@ -0,0 +1,85 @@
+#include "utils.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::led::utils;
+
+static constexpr auto ledIface = "xyz.openbmc_project.Led.Physical";
+static constexpr auto groupIface = "xyz.openbmc_project.Led.Group";
+
+TEST(ServiceCacheTest, testHitsAndMisses)
+{
+    ServiceCache cache;
+
+    ASSERT_FALSE(cache.find("/led/a", ledIface));
+    cache.insert("/led/a", ledIface, "svc.a", cache.getGeneration());
+    ASSERT_EQ("svc.a", cache.find("/led/a", ledIface));
+    ASSERT_FALSE(cache.find("/led/a", groupIface));
+
+    ASSERT_EQ(1, cache.getHits());
+    ASSERT_EQ(2, cache.getMisses());
+}
+
+TEST(ServiceCacheTest, testLeastRecentlyUsedEvicted)
+{
+    ServiceCache cache(2);
+
+    cache.insert("/led/a", ledIface, "svc.a", cache.getGeneration());
+    cache.insert("/led/b", ledIface, "svc.b", cache.getGeneration());
+    ASSERT_TRUE(cache.find("/led/a", ledIface));
+    cache.insert("/led/c", ledIface, "svc.c", cache.getGeneration());
+
+    ASSERT_EQ(2, cache.size());
+    ASSERT_TRUE(cache.find("/led/a", ledIface));
+    ASSERT_FALSE(cache.find("/led/b", ledIface));
+    ASSERT_TRUE(cache.find("/led/c", ledIface));
+}
+
+TEST(ServiceCacheTest, testInvalidation)
+{
+    ServiceCache cache;
+
+    cache.insert("/led/a", ledIface, "svc.a", cache.getGeneration());
+    cache.insert("/led/a", groupIface, "svc.b", cache.getGeneration());
+    cache.insert("/led/b", ledIface, "svc.a", cache.getGeneration());
+
+    cache.eraseService("svc.a");
+    ASSERT_EQ(1, cache.size());
+    ASSERT_EQ("svc.b", cache.find("/led/a", groupIface));
+
+    cache.erasePath("/led/a");
+    ASSERT_EQ(0, cache.size());
+}
+
+TEST(ServiceCacheTest, testStaleLookupNotCached)
+{
+    ServiceCache cache;
+
+    auto generation = cache.getGeneration();
+    cache.eraseService("svc.a");
+    cache.insert("/led/a", ledIface, "svc.a", generation);
+
+    ASSERT_FALSE(cache.find("/led/a", ledIface));
+}
+
+TEST(ServiceCacheTest, testWatchedOnFirstEntry)
+{
+    std::vector<std::string> watched;
+    ServiceCache cache(ServiceCache::defaultCapacity,
+                       [&watched](const std::string& service) {
+                           watched.emplace_back(service);
+                       });
+
+    cache.insert("/led/a", ledIface, "svc.a", cache.getGeneration());
+    cache.insert("/led/b", ledIface, "svc.a", cache.getGeneration());
+    cache.insert("/led/a", groupIface, "svc.b", cache.getGeneration());
+    ASSERT_EQ((std::vector<std::string>{"svc.a", "svc.b"}), watched);
+
+    // Cached again once its entries were dropped
+    cache.eraseService("svc.a");
+    cache.insert("/led/a", ledIface, "svc.a", cache.getGeneration());
+    ASSERT_EQ(3, watched.size());
+}
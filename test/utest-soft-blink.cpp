@@ -0,0 +1,130 @@
+#include "soft-blink.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::led;
+
+class SoftBlinkTest : public ::testing::Test
+{
+  public:
+    /** @brief The batches handed over, one per tick with toggles */
+    std::vector<SoftBlink::Toggles> batches;
+
+    SoftBlink softBlink;
+
+    SoftBlinkTest() :
+        softBlink(sdeventplus::Event::get_default(),
+                  std::chrono::milliseconds(100),
+                  [this](const SoftBlink::Toggles& toggles) {
+                      batches.push_back(toggles);
+                  })
+    {}
+
+    /** @brief Runs ticks, returns the batches handed over meanwhile */
+    std::vector<SoftBlink::Toggles> advance(unsigned int count)
+    {
+        batches.clear();
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            softBlink.advance();
+        }
+        return batches;
+    }
+};
+
+TEST_F(SoftBlinkTest, testBlink)
+{
+    // 5 ticks on, 5 ticks off
+    softBlink.start("/led/one", 50, 1000);
+    ASSERT_EQ(1, batches.size());
+    ASSERT_EQ((SoftBlink::Toggles{{"/led/one", true}}), batches[0]);
+
+    ASSERT_TRUE(advance(4).empty());
+    ASSERT_EQ((std::vector<SoftBlink::Toggles>{{{"/led/one", false}}}),
+              advance(1));
+    ASSERT_TRUE(advance(4).empty());
+    ASSERT_EQ((std::vector<SoftBlink::Toggles>{{{"/led/one", true}}}),
+              advance(1));
+    ASSERT_TRUE(softBlink.isOn("/led/one"));
+}
+
+TEST_F(SoftBlinkTest, testPhaseLocked)
+{
+    softBlink.start("/led/one", 50, 1000);
+    advance(3);
+
+    // Joins in the on phase of the first LED
+    batches.clear();
+    softBlink.start("/led/two", 50, 1000);
+    ASSERT_EQ((SoftBlink::Toggles{{"/led/two", true}}), batches[0]);
+
+    // Both are toggled by the same tick, in one batch
+    advance(1);
+    auto toggled = advance(1);
+    ASSERT_EQ(1, toggled.size());
+    ASSERT_EQ(2, toggled[0].size());
+    ASSERT_FALSE(softBlink.isOn("/led/one"));
+    ASSERT_FALSE(softBlink.isOn("/led/two"));
+
+    // Started in the off phase
+    advance(2);
+    batches.clear();
+    softBlink.start("/led/three", 50, 1000);
+    ASSERT_EQ((SoftBlink::Toggles{{"/led/three", false}}), batches[0]);
+    ASSERT_EQ(3, advance(3)[0].size());
+}
+
+TEST_F(SoftBlinkTest, testLongPeriod)
+{
+    // Longer than a turn of the wheel: 100 ticks on, 100 ticks off
+    softBlink.start("/led/one", 50, 20000);
+
+    ASSERT_TRUE(advance(99).empty());
+    ASSERT_EQ(1, advance(1).size());
+    ASSERT_FALSE(softBlink.isOn("/led/one"));
+    ASSERT_TRUE(advance(99).empty());
+    ASSERT_EQ(1, advance(1).size());
+    ASSERT_TRUE(softBlink.isOn("/led/one"));
+}
+
+TEST_F(SoftBlinkTest, testRestartAndStop)
+{
+    softBlink.start("/led/one", 50, 1000);
+
+    // The same blink keeps its phase
+    advance(2);
+    batches.clear();
+    softBlink.start("/led/one", 50, 1000);
+    ASSERT_TRUE(batches.empty());
+
+    // A new duty cycle replaces the pending toggle: 2 ticks on
+    softBlink.start("/led/one", 20, 1000);
+    ASSERT_EQ(1, batches.size());
+    ASSERT_FALSE(softBlink.isOn("/led/one"));
+    ASSERT_TRUE(advance(7).empty());
+    ASSERT_EQ((std::vector<SoftBlink::Toggles>{{{"/led/one", true}}}),
+              advance(1));
+    ASSERT_EQ((std::vector<SoftBlink::Toggles>{{{"/led/one", false}}}),
+              advance(2));
+
+    softBlink.stop("/led/one");
+    ASSERT_FALSE(softBlink.contains("/led/one"));
+    ASSERT_TRUE(advance(20).empty());
+}
+
+TEST_F(SoftBlinkTest, testSteadyDutyCycle)
+{
+    softBlink.start("/led/off", 0, 1000);
+    softBlink.start("/led/on", 100, 1000);
+    ASSERT_EQ(2, batches.size());
+    ASSERT_FALSE(softBlink.isOn("/led/off"));
+    ASSERT_TRUE(softBlink.isOn("/led/on"));
+
+    ASSERT_TRUE(advance(20).empty());
+}
@@ -0,0 +1,90 @@
+#include "sysfs-led.hpp"
+
+#include <stdlib.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::led;
+
+namespace fs = std::filesystem;
+
+class SysfsLedTest : public ::testing::Test
+{
+  public:
+    fs::path device;
+
+    SysfsLedTest()
+    {
+        // A fake LED class device
+        char dir[] = "/tmp/sysfs-led-XXXXXX";
+        device = mkdtemp(dir);
+        for (const auto& attribute :
+             {"brightness", "trigger", "delay_on", "delay_off"})
+        {
+            std::ofstream(device / attribute) << "0\n";
+        }
+        std::ofstream(device / "max_brightness") << "255\n";
+    }
+
+    ~SysfsLedTest() override
+    {
+        fs::remove_all(device);
+    }
+
+    /** @brief Returns the value last written to an attribute */
+    std::string read(const char* attribute)
+    {
+        // Unlike sysfs, a regular file keeps the tail of a longer value
+        std::string value;
+        std::ifstream(device / attribute) >> value;
+        return value;
+    }
+};
+
+TEST_F(SysfsLedTest, testOnOff)
+{
+    SysfsLed led(device);
+
+    ASSERT_EQ(0, led.set(Layout::Action::On, 0, 0));
+    ASSERT_EQ("255", read("brightness"));
+    ASSERT_EQ("none", read("trigger"));
+
+    ASSERT_EQ(0, led.set(Layout::Action::Off, 0, 0));
+    ASSERT_EQ("0", read("brightness"));
+}
+
+TEST_F(SysfsLedTest, testBlink)
+{
+    SysfsLed led(device);
+
+    ASSERT_EQ(0, led.set(Layout::Action::Blink, 25, 1000));
+    ASSERT_EQ("timer", read("trigger"));
+    ASSERT_EQ("250", read("delay_on"));
+    ASSERT_EQ("750", read("delay_off"));
+}
+
+TEST_F(SysfsLedTest, testCachedDescriptors)
+{
+    SysfsLed led(device);
+    ASSERT_EQ(0, led.set(Layout::Action::On, 0, 0));
+
+    // The open descriptors keep writing the same attributes
+    fs::remove(device / "brightness");
+    fs::remove(device / "max_brightness");
+    ASSERT_EQ(0, led.set(Layout::Action::On, 0, 0));
+
+    // The delay attributes are opened for each blink
+    fs::remove(device / "delay_on");
+    ASSERT_GT(0, led.set(Layout::Action::Blink, 50, 1000));
+}
+
+TEST_F(SysfsLedTest, testMissingDevice)
+{
+    SysfsLed led(device / "missing");
+
+    ASSERT_GT(0, led.set(Layout::Action::On, 0, 0));
+}
@@ -2,6 +2,7 @@
 #include "manager.hpp"
 
 #include <sdbusplus/bus.hpp>
+#include <sdeventplus/event.hpp>
 
 #include <algorithm>
 #include <set>
@@ -12,9 +13,14 @@ class LedTest : public ::testing::Test
 {
   public:
     sdbusplus::bus::bus bus;
-    LedTest() : bus(sdbusplus::bus::new_default())
+    sdeventplus::Event event;
+    DriverConfig config;
+    LedTest() :
+        bus(sdbusplus::bus::new_default()),
+        event(sdeventplus::Event::get_default())
     {
-        // Nothing here
+        // The physical LEDs are not watched on the test bus
+        config.driftPolicy = DriftPolicy::Ignore;
     }
     ~LedTest()
     {
@@ -25,7 +31,7 @@ class LedTest : public ::testing::Test
 /** @brief Assert Single LED to On */
 TEST_F(LedTest, assertSingleLedOn)
 {
-    Manager manager(bus, singleLedOn);
+    Manager manager(bus, singleLedOn, event, config);
     {
         // Assert the LEDs.
         ActionSet ledsAssert{};
@@ -56,7 +62,7 @@ TEST_F(LedTest, assertSingleLedOn)
 /** @brief Assert Single LED to Blink */
 TEST_F(LedTest, assertSingleLedBlink)
 {
-    Manager manager(bus, singleLedBlink);
+    Manager manager(bus, singleLedBlink, event, config);
     {
         // Assert the LEDs.
         ActionSet ledsAssert{};
@@ -87,7 +93,7 @@ TEST_F(LedTest, assertSingleLedBlink)
 /** @brief Assert Single LED to On and Try Assert Again */
 TEST_F(LedTest, assertSingleLedOnAndreAssert)
 {
-    Manager manager(bus, singleLedOn);
+    Manager manager(bus, singleLedOn, event, config);
     {
         // Assert the LEDs.
         ActionSet ledsAssert{};
@@ -131,7 +137,7 @@ TEST_F(LedTest, assertSingleLedOnAndreAssert)
 /** @brief Assert Multiple LEDs to On */
 TEST_F(LedTest, assertMultipleLedOn)
 {
-    Manager manager(bus, multipleLedsOn);
+    Manager manager(bus, multipleLedsOn, event, config);
     {
         // Assert the LEDs.
         ActionSet ledsAssert{};
@@ -166,7 +172,7 @@ TEST_F(LedTest, assertMultipleLedOn)
 /** @brief Assert Multiple LEDs to Blink */
 TEST_F(LedTest, assertMultipleLedBlink)
 {
-    Manager manager(bus, multipleLedsBlink);
+    Manager manager(bus, multipleLedsBlink, event, config);
     {
         // Assert the LEDs.
         ActionSet ledsAssert{};
@@ -201,7 +207,7 @@ TEST_F(LedTest, assertMultipleLedBlink)
 /** @brief Assert Multiple LEDs to Blink, DeAssert */
 TEST_F(LedTest, assertMultipleLedBlinkAndDeAssert)
 {
-    Manager manager(bus, multipleLedsBlink);
+    Manager manager(bus, multipleLedsBlink, event, config);
     {
         // Assert the LEDs.
         ActionSet ledsAssert{};
@@ -265,7 +271,7 @@ TEST_F(LedTest, assertMultipleLedBlinkAndDeAssert)
 /** @brief Assert Multiple LEDs to Blink, DeAssert Twice */
 TEST_F(LedTest, assertMultipleLedBlinkAndDeAssertTwice)
 {
-    Manager manager(bus, multipleLedsBlink);
+    Manager manager(bus, multipleLedsBlink, event, config);
     {
         // Assert the LEDs.
         ActionSet ledsAssert{};
@@ -341,7 +347,7 @@ TEST_F(LedTest, assertMultipleLedBlinkAndDeAssertTwice)
 /** @brief Assert Multiple LEDs to mix of On and Blink */
 TEST_F(LedTest, assertMultipleLedOnAndBlink)
 {
-    Manager manager(bus, multipleLedsOnAndBlink);
+    Manager manager(bus, multipleLedsOnAndBlink, event, config);
     {
         // Assert the LEDs.
         ActionSet ledsAssert{};
@@ -380,7 +386,7 @@ TEST_F(LedTest, assertMultipleLedOnAndBlink)
 /** @brief Assert 2 groups having distinct LEDs */
 TEST_F(LedTest, assertTwoGroupsOnWithDistinctLEDOn)
 {
-    Manager manager(bus, twoGroupsWithDistinctLEDsOn);
+    Manager manager(bus, twoGroupsWithDistinctLEDsOn, event, config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -444,7 +450,7 @@ TEST_F(LedTest, assertTwoGroupsOnWithDistinctLEDOn)
 /** @brief Assert 2 groups having one of the LEDs common */
 TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOn)
 {
-    Manager manager(bus, twoGroupsWithOneComonLEDOn);
+    Manager manager(bus, twoGroupsWithOneComonLEDOn, event, config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -507,7 +513,8 @@ TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOn)
  * priority and Deassert*/
 TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOnOneLEDBlinkPriorityAndDeAssertB)
 {
-    Manager manager(bus, twoGroupsWithOneComonLEDOnOneLEDBlinkPriority);
+    Manager manager(bus, twoGroupsWithOneComonLEDOnOneLEDBlinkPriority, event,
+                    config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -599,7 +606,8 @@ TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOnOneLEDBlinkPriorityAndDeAssertB)
  * priority and Deassert A */
 TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOnOneLEDBlinkPriorityAndDeAssertA)
 {
-    Manager manager(bus, twoGroupsWithOneComonLEDOnOneLEDBlinkPriority);
+    Manager manager(bus, twoGroupsWithOneComonLEDOnOneLEDBlinkPriority, event,
+                    config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -703,7 +711,7 @@ TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOnOneLEDBlinkPriorityAndDeAssertA)
  * priority And Deassert A */
 TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOnOneLEDOnPriorityAndDeAssertA)
 {
-    Manager manager(bus, twoGroupsWithOneComonLEDOnPriority);
+    Manager manager(bus, twoGroupsWithOneComonLEDOnPriority, event, config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -796,7 +804,7 @@ TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOnOneLEDOnPriorityAndDeAssertA)
  * priority And Deassert B */
 TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOnOneLEDOnPriorityAndDeAssertB)
 {
-    Manager manager(bus, twoGroupsWithOneComonLEDOnPriority);
+    Manager manager(bus, twoGroupsWithOneComonLEDOnPriority, event, config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -901,7 +909,7 @@ TEST_F(LedTest, asserttwoGroupsWithOneComonLEDOnOneLEDOnPriorityAndDeAssertB)
 /** @brief Assert 2 groups having multiple common LEDs in Same State */
 TEST_F(LedTest, assertTwoGroupsWithMultiplComonLEDOnAndDeAssert)
 {
-    Manager manager(bus, twoGroupsWithMultiplComonLEDOn);
+    Manager manager(bus, twoGroupsWithMultiplComonLEDOn, event, config);
     {
         // Assert Set-B
         ActionSet ledsAssert{};
@@ -990,7 +998,8 @@ TEST_F(LedTest, assertTwoGroupsWithMultiplComonLEDOnAndDeAssert)
 /** @brief Assert 2 groups having multiple LEDs common in different state */
 TEST_F(LedTest, assertTwoGroupsWithMultipleComonLEDInDifferentStateBandA)
 {
-    Manager manager(bus, twoGroupsWithMultipleComonLEDInDifferentState);
+    Manager manager(bus, twoGroupsWithMultipleComonLEDInDifferentState, event,
+                    config);
     {
         // Assert Set-B
         ActionSet ledsAssert{};
@@ -1056,7 +1065,8 @@ TEST_F(LedTest, assertTwoGroupsWithMultipleComonLEDInDifferentStateBandA)
 /** @brief Assert 2 groups having multiple LEDs common in different state */
 TEST_F(LedTest, assertTwoGroupsWithMultipleComonLEDInDifferentStateAtoB)
 {
-    Manager manager(bus, twoGroupsWithMultipleComonLEDInDifferentState);
+    Manager manager(bus, twoGroupsWithMultipleComonLEDInDifferentState, event,
+                    config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -1128,7 +1138,8 @@ TEST_F(LedTest, assertTwoGroupsWithMultipleComonLEDInDifferentStateAtoB)
 TEST_F(LedTest,
        assertTwoGroupsWithMultipleComonLEDInDifferentStateAtoBDeAssertTwice)
 {
-    Manager manager(bus, twoGroupsWithMultipleComonLEDInDifferentState);
+    Manager manager(bus, twoGroupsWithMultipleComonLEDInDifferentState, event,
+                    config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -1284,7 +1295,8 @@ TEST_F(LedTest,
        assertTwoGroupsWithMultipleComonLEDInDifferentStateDiffPriorityAandB)
 {
     Manager manager(bus,
-                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority);
+                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority,
+                    event, config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -1396,7 +1408,8 @@ TEST_F(
     assertTwoGroupsWithMultipleComonLEDInDifferentStateDiffPriorityAandBDeAssertB)
 {
     Manager manager(bus,
-                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority);
+                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority,
+                    event, config);
     {
         // Assert Set-A
         ActionSet ledsAssert{};
@@ -1507,7 +1520,8 @@ TEST_F(LedTest,
        assertTwoGroupsWithMultipleComonLEDInDifferentStateDiffPriorityBandA)
 {
     Manager manager(bus,
-                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority);
+                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority,
+                    event, config);
     {
         // Assert Set-B
         ActionSet ledsAssert{};
@@ -1583,7 +1597,8 @@ TEST_F(
     assertTwoGroupsWithMultipleComonLEDInDifferentStateDiffPriorityBandADeAssertA)
 {
     Manager manager(bus,
-                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority);
+                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority,
+                    event, config);
     {
         // Assert Set-B
         ActionSet ledsAssert{};
@@ -1695,7 +1710,8 @@ TEST_F(LedTest,
        assertTwoGroupsWithMultipleComonLEDInDifferentStateOnBlinkPriorityBandA)
 {
     Manager manager(bus,
-                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority);
+                    twoGroupsWithMultipleComonLEDInDifferentStateDiffPriority,
+                    event, config);
     {
         // Assert Set-B
         ActionSet ledsAssert{};
@@ -1849,3 +1865,125 @@ TEST_F(LedTest,
         EXPECT_EQ(0, ledsAssert.size());
     }
 }
+
+/** @brief Assert 2 groups having one of the LEDs common in one transition */
+TEST_F(LedTest, assertTwoGroupsWithOneComonLEDOnAtOnce)
+{
+    Manager manager(bus, twoGroupsWithOneComonLEDOn, event, config);
+    {
+        // Assert Set-A and Set-B
+        ActionSet ledsAssert{};
+        ActionSet ledsDeAssert{};
+
+        GroupStates states = {
+            {"/xyz/openbmc_project/ledmanager/groups/MultipleLedsASet", true},
+            {"/xyz/openbmc_project/ledmanager/groups/MultipleLedsBSet", true},
+        };
+        manager.setGroupStates(states, ledsAssert, ledsDeAssert);
+
+        // Need just the ledsAssserted populated with these.
+        ActionSet refAssert = {
+            {"One", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+            {"Two", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+            {"Three", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+            {"Four", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+            {"Six", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+        };
+        EXPECT_EQ(refAssert.size(), ledsAssert.size());
+        EXPECT_EQ(0, ledsDeAssert.size());
+
+        // difference of refAssert and ledsAssert must be null.
+        ActionSet temp{};
+        std::set_difference(ledsAssert.begin(), ledsAssert.end(),
+                            refAssert.begin(), refAssert.end(),
+                            std::inserter(temp, temp.begin()));
+        EXPECT_EQ(0, temp.size());
+    }
+    {
+        // DeAssert Set-A and Set-B
+        ActionSet ledsAssert{};
+        ActionSet ledsDeAssert{};
+
+        GroupStates states = {
+            {"/xyz/openbmc_project/ledmanager/groups/MultipleLedsASet", false},
+            {"/xyz/openbmc_project/ledmanager/groups/MultipleLedsBSet", false},
+        };
+        manager.setGroupStates(states, ledsAssert, ledsDeAssert);
+
+        // Need just the ledsDeAssserted populated with these.
+        ActionSet refDeAssert = {
+            {"One", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+            {"Two", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+            {"Three", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+            {"Four", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+            {"Six", phosphor::led::Layout::Action::On, 0, 0,
+             phosphor::led::Layout::Action::On},
+        };
+        EXPECT_EQ(refDeAssert.size(), ledsDeAssert.size());
+        EXPECT_EQ(0, ledsAssert.size());
+
+        // difference of refDeAssert and ledsDeAssert must be null.
+        ActionSet temp{};
+        std::set_difference(ledsDeAssert.begin(), ledsDeAssert.end(),
+                            refDeAssert.begin(), refDeAssert.end(),
+                            std::inserter(temp, temp.begin()));
+        EXPECT_EQ(0, temp.size());
+    }
+}
+
+/** @brief Effective state lists the asserted groups behind each LED */
+TEST_F(LedTest, effectiveStateOfTwoGroupsWithOneComonLEDOn)
+{
+    Manager manager(bus, twoGroupsWithOneComonLEDOn, event, config);
+
+    auto groupA = "/xyz/openbmc_project/ledmanager/groups/MultipleLedsASet";
+    auto groupB = "/xyz/openbmc_project/ledmanager/groups/MultipleLedsBSet";
+
+    EXPECT_EQ(0, manager.getEffectiveState().size());
+
+    ActionSet ledsAssert{};
+    ActionSet ledsDeAssert{};
+    manager.setGroupState(groupA, true, ledsAssert, ledsDeAssert);
+    manager.setGroupState(groupB, true, ledsAssert, ledsDeAssert);
+
+    auto states = manager.getEffectiveState();
+    EXPECT_EQ(5, states.size());
+    for (const auto& state : states)
+    {
+        EXPECT_EQ(phosphor::led::Layout::Action::On, state.action);
+        EXPECT_EQ(phosphor::led::Layout::Action::On, state.priority);
+        if (state.name == "One" || state.name == "Two")
+        {
+            EXPECT_EQ(std::vector<std::string>{groupA}, state.groups);
+        }
+        else if (state.name == "Four" || state.name == "Six")
+        {
+            EXPECT_EQ(std::vector<std::string>{groupB}, state.groups);
+        }
+        else
+        {
+            EXPECT_EQ("Three", state.name);
+            std::set<std::string> groups(state.groups.begin(),
+                                         state.groups.end());
+            EXPECT_EQ((std::set<std::string>{groupA, groupB}), groups);
+        }
+    }
+
+    manager.setGroupState(groupA, false, ledsAssert, ledsDeAssert);
+
+    states = manager.getEffectiveState();
+    EXPECT_EQ(3, states.size());
+    for (const auto& state : states)
+    {
+        EXPECT_EQ(std::vector<std::string>{groupB}, state.groups);
+    }
+}
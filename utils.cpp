@@ -1,6 +1,13 @@
 #include "utils.hpp"
 
 #include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/exception.hpp>
+
+#include <cerrno>
+#include <functional>
+#include <iterator>
+#include <memory>
 
 namespace phosphor
 {
@@ -9,10 +16,236 @@ namespace led
 namespace utils
 {
 
+namespace
+{
+
+/** @brief Key of a cached service */
+std::string serviceKey(const std::string& path, const std::string& interface)
+{
+    // A space is valid in neither an object path nor an interface
+    return path + ' ' + interface;
+}
+
+/** @brief Drops a use of a counted name */
+void release(std::unordered_map<std::string, size_t>& counts,
+             const std::string& name)
+{
+    auto it = counts.find(name);
+    if (it != counts.end() && --it->second == 0)
+    {
+        counts.erase(it);
+    }
+}
+
+} // namespace
+
+std::optional<std::string> ServiceCache::find(const std::string& path,
+                                              const std::string& interface)
+{
+    auto it = keys.find(serviceKey(path, interface));
+    if (it == keys.end())
+    {
+        ++misses;
+        return std::nullopt;
+    }
+
+    ++hits;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->service;
+}
+
+void ServiceCache::insert(const std::string& path,
+                          const std::string& interface,
+                          const std::string& service, uint64_t generation)
+{
+    if (generation != this->generation || capacity == 0)
+    {
+        // Invalidated while it was looked up
+        return;
+    }
+
+    auto key = serviceKey(path, interface);
+    auto it = keys.find(key);
+    if (it != keys.end())
+    {
+        erase(it->second);
+    }
+    else if (entries.size() >= capacity)
+    {
+        erase(std::prev(entries.end()));
+    }
+
+    entries.push_front(Entry{key, path, service});
+    keys.emplace(std::move(key), entries.begin());
+    ++paths[path];
+    if (++services[service] == 1 && watch)
+    {
+        watch(service);
+    }
+}
+
+void ServiceCache::erase(const std::string& path, const std::string& interface)
+{
+    ++generation;
+
+    auto it = keys.find(serviceKey(path, interface));
+    if (it != keys.end())
+    {
+        erase(it->second);
+    }
+}
+
+void ServiceCache::erasePath(const std::string& path)
+{
+    ++generation;
+
+    if (!paths.contains(path))
+    {
+        return;
+    }
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        auto entry = it++;
+        if (entry->path == path)
+        {
+            erase(entry);
+        }
+    }
+}
+
+void ServiceCache::eraseService(const std::string& service)
+{
+    ++generation;
+
+    if (!services.contains(service))
+    {
+        return;
+    }
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        auto entry = it++;
+        if (entry->service == service)
+        {
+            erase(entry);
+        }
+    }
+}
+
+void ServiceCache::logStats() const
+{
+    lg2::info("Service cache lookups, HITS = {HITS}, MISSES = {MISSES}, "
+              "ENTRIES = {ENTRIES}",
+              "HITS", hits, "MISSES", misses, "ENTRIES", entries.size());
+}
+
+void ServiceCache::erase(Entries::iterator entry)
+{
+    release(paths, entry->path);
+    release(services, entry->service);
+    keys.erase(entry->key);
+    entries.erase(entry);
+}
+
+namespace
+{
+
+/** @brief The shared service names cache, with the signal matches keeping
+ *         it current
+ */
+struct CachedServices
+{
+    explicit CachedServices(sdbusplus::bus::bus& bus) :
+        bus(bus),
+        cache(ServiceCache::defaultCapacity,
+              std::bind_front(&CachedServices::watch, this)),
+        interfacesAdded(
+            bus,
+            sdbusplus::bus::match::rules::interfacesAdded() +
+                sdbusplus::bus::match::rules::sender(MAPPER_BUSNAME),
+            std::bind_front(&CachedServices::objectChanged, this)),
+        interfacesRemoved(
+            bus,
+            sdbusplus::bus::match::rules::interfacesRemoved() +
+                sdbusplus::bus::match::rules::sender(MAPPER_BUSNAME),
+            std::bind_front(&CachedServices::objectChanged, this))
+    {}
+
+    /** @brief Watches the owner of a service, once it is cached */
+    void watch(const std::string& service)
+    {
+        if (ownerChanged.contains(service))
+        {
+            return;
+        }
+
+        ownerChanged.emplace(
+            service,
+            std::make_unique<sdbusplus::bus::match_t>(
+                bus, sdbusplus::bus::match::rules::nameOwnerChanged(service),
+                std::bind_front(&CachedServices::serviceChanged, this)));
+    }
+
+    /** @brief Drops the entries of a service leaving or changing owner */
+    void serviceChanged(sdbusplus::message::message& msg)
+    {
+        std::string name;
+        try
+        {
+            msg.read(name);
+        }
+        catch (const sdbusplus::exception::exception&)
+        {
+            return;
+        }
+
+        // The service left, or is another process now
+        cache.eraseService(name);
+    }
+
+    /** @brief Drops the entries of an object gaining or losing interfaces */
+    void objectChanged(sdbusplus::message::message& msg)
+    {
+        sdbusplus::message::object_path path;
+        try
+        {
+            msg.read(path);
+        }
+        catch (const sdbusplus::exception::exception&)
+        {
+            return;
+        }
+
+        cache.erasePath(path.str);
+    }
+
+    sdbusplus::bus::bus& bus;
+    ServiceCache cache;
+    std::unordered_map<std::string, std::unique_ptr<sdbusplus::bus::match_t>>
+        ownerChanged;
+    sdbusplus::bus::match_t interfacesAdded;
+    sdbusplus::bus::match_t interfacesRemoved;
+};
+
+} // namespace
+
+ServiceCache& DBusHandler::getServiceCache()
+{
+    static CachedServices cachedServices(DBusHandler::getBus());
+    return cachedServices.cache;
+}
+
 // Get service name
 const std::string DBusHandler::getService(const std::string& path,
                                           const std::string& interface) const
 {
+    auto& cache = getServiceCache();
+    if (auto service = cache.find(path, interface))
+    {
+        return *service;
+    }
+    auto generation = cache.getGeneration();
 
     using InterfaceList = std::vector<std::string>;
     std::unordered_map<std::string, std::vector<std::string>> mapperResponse;
@@ -34,7 +267,10 @@ const std::string DBusHandler::getService(const std::string& path,
     }
 
     // the value here will be the service name
-    return mapperResponse.cbegin()->first;
+    const auto& service = mapperResponse.cbegin()->first;
+    cache.insert(path, interface, service, generation);
+
+    return service;
 }
 
 // Get all properties
@@ -55,8 +291,17 @@ const PropertyMap
                                       DBUS_PROPERTY_IFACE, "GetAll");
     method.append(interface);
 
-    auto reply = bus.call(method);
-    reply.read(properties);
+    try
+    {
+        auto reply = bus.call(method);
+        reply.read(properties);
+    }
+    catch (const sdbusplus::exception::exception&)
+    {
+        // The object may have moved to another service
+        getServiceCache().erase(objectPath, interface);
+        throw;
+    }
 
     return properties;
 }
@@ -80,8 +325,17 @@ const PropertyValue
                                       DBUS_PROPERTY_IFACE, "Get");
     method.append(interface, propertyName);
 
-    auto reply = bus.call(method);
-    reply.read(value);
+    try
+    {
+        auto reply = bus.call(method);
+        reply.read(value);
+    }
+    catch (const sdbusplus::exception::exception&)
+    {
+        // The object may have moved to another service
+        getServiceCache().erase(objectPath, interface);
+        throw;
+    }
 
     return value;
 }
@@ -103,7 +357,16 @@ void DBusHandler::setProperty(const std::string& objectPath,
                                       DBUS_PROPERTY_IFACE, "Set");
     method.append(interface.c_str(), propertyName.c_str(), value);
 
-    bus.call_noreply(method);
+    try
+    {
+        bus.call_noreply(method);
+    }
+    catch (const sdbusplus::exception::exception&)
+    {
+        // The object may have moved to another service
+        getServiceCache().erase(objectPath, interface);
+        throw;
+    }
 }
 
 const std::vector<std::string>
@@ -126,6 +389,267 @@ const std::vector<std::string>
     return paths;
 }
 
+namespace
+{
+
+/** @brief sd-bus callback of an asynchronous call */
+int asyncReply(sd_bus_message* msg, void* userdata, sd_bus_error* /*error*/)
+{
+    auto& callback = *static_cast<ReplyCallback*>(userdata);
+    auto reply = sdbusplus::message::message(msg);
+
+    try
+    {
+        callback(reply.is_method_error() ? -reply.get_errno() : 0, reply);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to handle a D-Bus reply, ERROR = {ERROR}", "ERROR",
+                   e);
+    }
+
+    return 0;
+}
+
+/** @brief Frees the callback of an asynchronous call with its slot */
+void asyncDestroy(void* userdata)
+{
+    delete static_cast<ReplyCallback*>(userdata);
+}
+
+/** @brief Reads a reply, returns the errno of a failed read */
+template <typename T>
+int readReply(int ec, sdbusplus::message::message& reply, T& value)
+{
+    if (ec < 0)
+    {
+        return ec;
+    }
+
+    try
+    {
+        reply.read(value);
+    }
+    catch (const sdbusplus::exception::exception& e)
+    {
+        return -e.get_errno();
+    }
+
+    return 0;
+}
+
+} // namespace
+
+void AsyncDBusHandler::call(sdbusplus::message::message& method,
+                            ReplyCallback callback,
+                            std::chrono::microseconds timeout) const
+{
+    auto userdata = std::make_unique<ReplyCallback>(std::move(callback));
+
+    sd_bus_slot* slot = nullptr;
+    auto r = sd_bus_call_async(getBus().get(), &slot, method.get(), asyncReply,
+                               userdata.get(), timeout.count());
+    if (r < 0)
+    {
+        (*userdata)(r, method);
+        return;
+    }
+
+    // The bus owns the slot, which frees the callback once the call is done
+    sd_bus_slot_set_destroy_callback(slot, asyncDestroy);
+    sd_bus_slot_set_floating(slot, 1);
+    sd_bus_slot_unref(slot);
+    userdata.release();
+}
+
+void AsyncDBusHandler::getService(
+    const std::string& path, const std::string& interface,
+    std::function<void(int ec, const std::string&)> callback,
+    std::chrono::microseconds timeout) const
+{
+    auto& cache = DBusHandler::getServiceCache();
+    if (auto service = cache.find(path, interface))
+    {
+        callback(0, *service);
+        return;
+    }
+    auto generation = cache.getGeneration();
+
+    using InterfaceList = std::vector<std::string>;
+
+    auto mapper = getBus().new_method_call(MAPPER_BUSNAME, MAPPER_OBJ_PATH,
+                                           MAPPER_IFACE, "GetObject");
+    mapper.append(path, InterfaceList({interface}));
+
+    call(
+        mapper,
+        [path, interface, generation, callback = std::move(callback)](
+            int ec, sdbusplus::message::message& reply) {
+            std::unordered_map<std::string, std::vector<std::string>>
+                mapperResponse;
+            ec = readReply(ec, reply, mapperResponse);
+            if (ec == 0 && mapperResponse.empty())
+            {
+                ec = -ENOENT;
+            }
+
+            if (ec < 0)
+            {
+                callback(ec, {});
+                return;
+            }
+
+            // the value here will be the service name
+            const auto& service = mapperResponse.cbegin()->first;
+            DBusHandler::getServiceCache().insert(path, interface, service,
+                                                  generation);
+            callback(ec, service);
+        },
+        timeout);
+}
+
+void AsyncDBusHandler::getAllProperties(
+    const std::string& objectPath, const std::string& interface,
+    std::function<void(int ec, const PropertyMap&)> callback,
+    std::chrono::microseconds timeout) const
+{
+    getService(
+        objectPath, interface,
+        [handler = *this, objectPath, interface, callback = std::move(callback),
+         timeout](int ec, const std::string& service) {
+            if (ec < 0)
+            {
+                callback(ec, {});
+                return;
+            }
+
+            auto method = handler.getBus().new_method_call(
+                service.c_str(), objectPath.c_str(), DBUS_PROPERTY_IFACE,
+                "GetAll");
+            method.append(interface);
+
+            handler.call(
+                method,
+                [objectPath, interface,
+                 callback](int ec, sdbusplus::message::message& reply) {
+                    if (ec < 0)
+                    {
+                        // The object may have moved to another service
+                        DBusHandler::getServiceCache().erase(objectPath,
+                                                             interface);
+                    }
+                    PropertyMap properties;
+                    ec = readReply(ec, reply, properties);
+                    callback(ec, properties);
+                },
+                timeout);
+        },
+        timeout);
+}
+
+void AsyncDBusHandler::getProperty(
+    const std::string& objectPath, const std::string& interface,
+    const std::string& propertyName,
+    std::function<void(int ec, const PropertyValue&)> callback,
+    std::chrono::microseconds timeout) const
+{
+    getService(
+        objectPath, interface,
+        [handler = *this, objectPath, interface, propertyName,
+         callback = std::move(callback),
+         timeout](int ec, const std::string& service) {
+            if (ec < 0)
+            {
+                callback(ec, {});
+                return;
+            }
+
+            auto method = handler.getBus().new_method_call(
+                service.c_str(), objectPath.c_str(), DBUS_PROPERTY_IFACE,
+                "Get");
+            method.append(interface, propertyName);
+
+            handler.call(
+                method,
+                [objectPath, interface,
+                 callback](int ec, sdbusplus::message::message& reply) {
+                    if (ec < 0)
+                    {
+                        // The object may have moved to another service
+                        DBusHandler::getServiceCache().erase(objectPath,
+                                                             interface);
+                    }
+                    PropertyValue value{};
+                    ec = readReply(ec, reply, value);
+                    callback(ec, value);
+                },
+                timeout);
+        },
+        timeout);
+}
+
+void AsyncDBusHandler::setProperty(const std::string& objectPath,
+                                   const std::string& interface,
+                                   const std::string& propertyName,
+                                   const PropertyValue& value,
+                                   std::function<void(int ec)> callback,
+                                   std::chrono::microseconds timeout) const
+{
+    getService(
+        objectPath, interface,
+        [handler = *this, objectPath, interface, propertyName, value,
+         callback = std::move(callback),
+         timeout](int ec, const std::string& service) {
+            if (ec < 0)
+            {
+                callback(ec);
+                return;
+            }
+
+            auto method = handler.getBus().new_method_call(
+                service.c_str(), objectPath.c_str(), DBUS_PROPERTY_IFACE,
+                "Set");
+            method.append(interface.c_str(), propertyName.c_str(), value);
+
+            handler.call(
+                method,
+                [objectPath, interface,
+                 callback](int ec, sdbusplus::message::message& /*reply*/) {
+                    if (ec < 0)
+                    {
+                        // The object may have moved to another service
+                        DBusHandler::getServiceCache().erase(objectPath,
+                                                             interface);
+                    }
+                    callback(ec);
+                },
+                timeout);
+        },
+        timeout);
+}
+
+void AsyncDBusHandler::getSubTreePaths(
+    const std::string& objectPath, const std::string& interface,
+    std::function<void(int ec, const std::vector<std::string>&)> callback,
+    std::chrono::microseconds timeout) const
+{
+    auto method = getBus().new_method_call(MAPPER_BUSNAME, MAPPER_OBJ_PATH,
+                                           MAPPER_IFACE, "GetSubTreePaths");
+    method.append(objectPath.c_str());
+    method.append(0); // Depth 0 to search all
+    method.append(std::vector<std::string>({interface.c_str()}));
+
+    call(
+        method,
+        [callback = std::move(callback)](int ec,
+                                         sdbusplus::message::message& reply) {
+            std::vector<std::string> paths;
+            ec = readReply(ec, reply, paths);
+            callback(ec, paths);
+        },
+        timeout);
+}
+
 } // namespace utils
 } // namespace led
 } // namespace phosphor
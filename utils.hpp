@@ -1,7 +1,14 @@
 #pragma once
 #include <sdbusplus/server.hpp>
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 namespace phosphor
 {
@@ -26,6 +33,139 @@ using DbusProperty = std::string;
 // The Map to constructs all properties values of the interface
 using PropertyMap = std::unordered_map<DbusProperty, PropertyValue>;
 
+/**
+ *  @class ServiceCache
+ *
+ *  Least recently used cache of the service names, by object path and
+ *  interface
+ *
+ *  The entries are dropped when the service leaves the bus or when the
+ *  object gains or loses interfaces. A lookup started before such a change
+ *  is not cached, see getGeneration(). The owner of each cached service can
+ *  be watched, see Watch.
+ */
+class ServiceCache
+{
+  public:
+    /** @brief Number of entries kept by the shared cache */
+    static constexpr size_t defaultCapacity = 512;
+
+    /** @brief Invoked with a service when it gets its first entry */
+    using Watch = std::function<void(const std::string& service)>;
+
+    /** @brief Constructs an empty cache
+     *
+     *  @param[in] capacity - Number of entries kept, the least recently used
+     *                        entry is evicted beyond it
+     *  @param[in] watch    - Invoked with a service when it gets its first
+     *                        entry, if set
+     */
+    explicit ServiceCache(size_t capacity = defaultCapacity,
+                          Watch watch = {}) :
+        capacity(capacity),
+        watch(std::move(watch))
+    {}
+
+    /** @brief Looks up a service, counting a hit or a miss
+     *
+     *  @param[in] path      - D-Bus object path
+     *  @param[in] interface - D-Bus interface
+     *
+     *  @return the service name, if cached
+     */
+    std::optional<std::string> find(const std::string& path,
+                                    const std::string& interface);
+
+    /** @brief Caches a service looked up from the mapper
+     *
+     *  @param[in] path       - D-Bus object path
+     *  @param[in] interface  - D-Bus interface
+     *  @param[in] service    - The service name
+     *  @param[in] generation - getGeneration() when the lookup started, the
+     *                          service is not cached if it changed since
+     */
+    void insert(const std::string& path, const std::string& interface,
+                const std::string& service, uint64_t generation);
+
+    /** @brief Drops the entry of an object path and interface */
+    void erase(const std::string& path, const std::string& interface);
+
+    /** @brief Drops the entries of an object path */
+    void erasePath(const std::string& path);
+
+    /** @brief Drops the entries of a service */
+    void eraseService(const std::string& service);
+
+    /** @brief Changes with every invalidation */
+    inline uint64_t getGeneration() const
+    {
+        return generation;
+    }
+
+    /** @brief Number of lookups answered from the cache */
+    inline uint64_t getHits() const
+    {
+        return hits;
+    }
+
+    /** @brief Number of lookups not answered from the cache */
+    inline uint64_t getMisses() const
+    {
+        return misses;
+    }
+
+    /** @brief Number of cached entries */
+    inline size_t size() const
+    {
+        return entries.size();
+    }
+
+    /** @brief Logs the counters of the lookups */
+    void logStats() const;
+
+  private:
+    /** @brief A cached service */
+    struct Entry
+    {
+        std::string key;
+        std::string path;
+        std::string service;
+    };
+
+    /** @brief The entries, most recently used first */
+    using Entries = std::list<Entry>;
+
+    /** @brief Number of entries kept */
+    size_t capacity;
+
+    /** @brief Invoked with a service when it gets its first entry */
+    Watch watch;
+
+    /** @brief The entries, most recently used first */
+    Entries entries;
+
+    /** @brief The entries, by key */
+    std::unordered_map<std::string, Entries::iterator> keys;
+
+    /** @brief Number of entries, by object path */
+    std::unordered_map<std::string, size_t> paths;
+
+    /** @brief Number of entries, by service */
+    std::unordered_map<std::string, size_t> services;
+
+    /** @brief Changes with every invalidation */
+    uint64_t generation = 0;
+
+    /** @brief Lookups answered from the cache */
+    uint64_t hits = 0;
+
+    /** @brief Lookups not answered from the cache */
+    uint64_t misses = 0;
+
+    /** @brief Drops an entry */
+    void erase(Entries::iterator entry);
+};
+
 /**
  *  @class DBusHandler
  *
@@ -43,8 +183,19 @@ class DBusHandler
         return bus;
     }
 
+    /** @brief Get the service names cache
+     *
+     *  @details The cache is shared by all the handlers of the process and
+     *           kept current with the NameOwnerChanged signals of the cached
+     *           services and the InterfacesAdded/Removed signals of the
+     *           mapper, received on the bus of getBus(). A call failing on a
+     *           cached service drops the entry as well.
+     */
+    static ServiceCache& getServiceCache();
+
     /**
-     *  @brief Get service name by the path and interface of the DBus.
+     *  @brief Get service name by the path and interface of the DBus, from
+     *         the cache if possible.
      *
      *  @param[in] path      -  D-Bus object path
      *  @param[in] interface -  D-Bus Interface
@@ -107,6 +258,128 @@ class DBusHandler
                         const std::string& interface);
 };
 
+/** @brief Completion of an asynchronous D-Bus call
+ *
+ *  @param[in] ec    - 0 on success, a negative errno otherwise, -ETIMEDOUT
+ *                     when the call timed out
+ *  @param[in] reply - The reply, only valid when ec is 0
+ */
+using ReplyCallback =
+    std::function<void(int ec, sdbusplus::message::message& reply)>;
+
+/**
+ *  @class AsyncDBusHandler
+ *
+ *  Asynchronous counterpart of DBusHandler
+ *
+ *  The calls are sent right away and the callbacks run from the event loop
+ *  the bus is attached to, so a slow peer does not block the caller. Each
+ *  D-Bus call made on behalf of a method is bounded by the given timeout.
+ */
+class AsyncDBusHandler
+{
+  public:
+    /** @brief Timeout of each D-Bus call, unless another one is given */
+    static constexpr std::chrono::microseconds defaultTimeout =
+        std::chrono::seconds(5);
+
+    /** @brief Uses the bus of DBusHandler */
+    AsyncDBusHandler() = default;
+
+    /** @brief Uses the given bus
+     *
+     *  @param[in] bus - The bus connection, attached to the event loop
+     */
+    explicit AsyncDBusHandler(sdbusplus::bus::bus& bus) : bus(&bus) {}
+
+    /** @brief Sends a method call
+     *
+     *  @param[in] method   - The method call
+     *  @param[in] callback - Invoked with the reply, or with the error if the
+     *                        call could not be sent
+     *  @param[in] timeout  - Timeout of the call
+     */
+    void call(sdbusplus::message::message& method, ReplyCallback callback,
+              std::chrono::microseconds timeout = defaultTimeout) const;
+
+    /** @brief Get service name by the path and interface of the DBus, from
+     *         the cache of DBusHandler if possible.
+     *
+     *  @param[in] path      - D-Bus object path
+     *  @param[in] interface - D-Bus Interface
+     *  @param[in] callback  - Invoked with the service name, right away when
+     *                         it is cached
+     *  @param[in] timeout   - Timeout of the call
+     */
+    void getService(const std::string& path, const std::string& interface,
+                    std::function<void(int ec, const std::string&)> callback,
+                    std::chrono::microseconds timeout = defaultTimeout) const;
+
+    /** @brief Get All properties
+     *
+     *  @param[in] objectPath - D-Bus object path
+     *  @param[in] interface  - D-Bus interface
+     *  @param[in] callback   - Invoked with the properties
+     *  @param[in] timeout    - Timeout of each call
+     */
+    void getAllProperties(
+        const std::string& objectPath, const std::string& interface,
+        std::function<void(int ec, const PropertyMap&)> callback,
+        std::chrono::microseconds timeout = defaultTimeout) const;
+
+    /** @brief Get property(type: variant)
+     *
+     *  @param[in] objectPath   - D-Bus object path
+     *  @param[in] interface    - D-Bus interface
+     *  @param[in] propertyName - D-Bus property name
+     *  @param[in] callback     - Invoked with the value of the property
+     *  @param[in] timeout      - Timeout of each call
+     */
+    void getProperty(const std::string& objectPath,
+                     const std::string& interface,
+                     const std::string& propertyName,
+                     std::function<void(int ec, const PropertyValue&)> callback,
+                     std::chrono::microseconds timeout = defaultTimeout) const;
+
+    /** @brief Set D-Bus property
+     *
+     *  @param[in] objectPath   - D-Bus object path
+     *  @param[in] interface    - D-Bus interface
+     *  @param[in] propertyName - D-Bus property name
+     *  @param[in] value        - The value to be set
+     *  @param[in] callback     - Invoked once the property is set
+     *  @param[in] timeout      - Timeout of each call
+     */
+    void setProperty(const std::string& objectPath,
+                     const std::string& interface,
+                     const std::string& propertyName,
+                     const PropertyValue& value,
+                     std::function<void(int ec)> callback,
+                     std::chrono::microseconds timeout = defaultTimeout) const;
+
+    /** @brief Get sub tree paths by the path and interface of the DBus.
+     *
+     *  @param[in] objectPath - D-Bus object path
+     *  @param[in] interface  - D-Bus object interface
+     *  @param[in] callback   - Invoked with the subtree paths
+     *  @param[in] timeout    - Timeout of the call
+     */
+    void getSubTreePaths(
+        const std::string& objectPath, const std::string& interface,
+        std::function<void(int ec, const std::vector<std::string>&)> callback,
+        std::chrono::microseconds timeout = defaultTimeout) const;
+
+  private:
+    /** @brief The bus connection, the one of DBusHandler if not set */
+    sdbusplus::bus::bus* bus = nullptr;
+
+    /** @brief Returns the bus connection */
+    inline sdbusplus::bus::bus& getBus() const
+    {
+        return bus ? *bus : DBusHandler::getBus();
+    }
+};
+
 } // namespace utils
 } // namespace led
 } // namespace phosphor